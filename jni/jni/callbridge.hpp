@@ -18,7 +18,14 @@
 // Generic callback for call forward
 qi::Future<qi::AnyValue>*    call_from_java(JNIEnv *env, qi::AnyObject object, const std::string& strMethodName, jobjectArray listParams);
 qi::AnyReference                 call_to_java(std::string signature, void* data, const qi::GenericFunctionParameters& params);
+qi::AnyReference                 call_to_java_async(std::string signature, void* data, const qi::GenericFunctionParameters& params);
 qi::AnyReference                 event_callback_to_java(void *vinfo, const std::vector<qi::AnyReference>& params);
+/**
+ * @brief abandonCall Request the cancellation of a future nobody will read, so that the result
+ * of the call it belongs to is dropped if it still arrives
+ * @param future Future of a call_from_java call, or of anything else (then only cancelled)
+ */
+void abandonCall(qi::Future<qi::AnyValue> future);
 /**
  * @brief checkJavaExceptionAndReport Check if last call to java have an error.
  * If error just happen, report it properly
@@ -0,0 +1,58 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#ifndef _COMPLETIONQUEUE_JNI_HPP_
+#define _COMPLETIONQUEUE_JNI_HPP_
+
+#include <jni.h>
+
+extern "C"
+{
+  /**
+   * Create a completion queue
+   * @param env JNI environment
+   * @param obj Caller object
+   * @return Completion queue pointer
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueCreate(JNIEnv* env, jobject obj);
+  /**
+   * Push the given tag into the completion queue when the future finishes
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Completion queue pointer
+   * @param future Java future to watch
+   * @param tag User tag reported with the completion
+   */
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueRegister(JNIEnv* env, jobject obj, jlong pQueue, jobject future, jlong tag);
+  /**
+   * Move up to tags.length completions into the given arrays, waiting for at least one if the queue is empty
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Completion queue pointer
+   * @param tags Receives the tags of the finished futures
+   * @param states Receives the states of the finished futures
+   * @param results Receives the values (or error messages) of the finished futures
+   * @param msecs Maximum time to wait, 0 for no wait, negative for infinite
+   * @return Number of completions moved
+   */
+  JNIEXPORT jint JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueDrain(JNIEnv* env, jobject obj, jlong pQueue, jlongArray tags, jintArray states, jobjectArray results, jlong msecs);
+  /**
+   * Wake up the threads draining the completion queue, their drain then throws an IllegalStateException
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Completion queue pointer
+   */
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueClose(JNIEnv* env, jobject obj, jlong pQueue);
+  /**
+   * Release the completion queue. Futures finishing afterwards are ignored
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Completion queue pointer
+   */
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueDestroy(JNIEnv* env, jobject obj, jlong pQueue);
+} // !extern "C"
+
+#endif //!_COMPLETIONQUEUE_JNI_HPP_
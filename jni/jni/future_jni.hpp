@@ -11,72 +11,165 @@
 #define _FUTURE_JNI_HPP_
 
 #include <jni.h>
+#include <vector>
 
 extern "C"
 {
   JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallCancel(JNIEnv *env, jobject obj, jlong pFuture);
   JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallCancelRequest(JNIEnv *env, jobject obj, jlong pFuture);
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallAbandon(JNIEnv *env, jobject obj, jlong pFuture);
   JNIEXPORT jobject JNICALL Java_com_aldebaran_qi_Future_qiFutureCallGet(JNIEnv *env, jobject obj, jlong pFuture, jint msecs);
   JNIEXPORT jstring JNICALL Java_com_aldebaran_qi_Future_qiFutureCallGetError(JNIEnv *env, jobject obj, jlong pFuture);
-  JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsCancelled(JNIEnv *env, jobject obj, jlong pFuture);
-  JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsDone(JNIEnv *env, jobject obj, jlong pFuture);
+  JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsCancelled(JNIEnv *env, jclass cls, jlong pFuture);
+  JNIEXPORT jboolean JNICALL JavaCritical_com_aldebaran_qi_Future_qiFutureCallIsCancelled(jlong pFuture);
+  JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsDone(JNIEnv *env, jclass cls, jlong pFuture);
+  JNIEXPORT jboolean JNICALL JavaCritical_com_aldebaran_qi_Future_qiFutureCallIsDone(jlong pFuture);
   JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallWaitWithTimeout(JNIEnv *env, jobject obj, jlong pFuture, jint timeout);
-  JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureDestroy(JNIEnv* env, jobject obj, jlong pFuture);
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureDestroy(JNIEnv* env, jclass cls, jlong pFuture, jint stateSlot);
+  /**
+   * Direct ByteBuffer over the state words of the futures polled from Java
+   * @param env JNI environment
+   * @param cls Future class
+   * @return The buffer
+   */
+  JNIEXPORT jobject JNICALL Java_com_aldebaran_qi_Future_qiFutureStateBuffer(JNIEnv* env, jclass cls);
+  /**
+   * Give a state word to the future, updated by native code when it finishes
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pFuture Future pointer
+   * @return Index of the word in the buffer, or -1 if none is available
+   */
+  JNIEXPORT jint JNICALL Java_com_aldebaran_qi_Future_qiFutureStateSlot(JNIEnv* env, jobject obj, jlong pFuture);
   JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallConnectCallback(JNIEnv *env, jobject obj, jlong pFuture, jobject callback, jint futureCallbackType);
+  /**
+   * Complete a java.util.concurrent.CompletableFuture with the state of the future when it finishes
+   * @param env JNI environment
+   * @param thisFuture Caller object
+   * @param pFuture Future pointer
+   * @param completableFuture CompletableFuture to complete
+   */
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCompleteInto(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject completableFuture);
   /**
    * Call native future "andThen" for Function(P)->R
    * @param env JNI environment
    * @param thisFuture Caller object
    * @param pFuture Future pointer
    * @param function Function to callback
+   * @param futureCallbackType How to call the function (qi::FutureCallbackType)
    * @return Created future
    */
-  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function, jint futureCallbackType);
   /**
    * Call native future "andThen" for Consumer(P)
    * @param env JNI environment
    * @param thisFuture Caller object
    * @param pFuture Future pointer
    * @param function Void function to callback
+   * @param futureCallbackType How to call the function (qi::FutureCallbackType)
    * @return Created future
    */
-  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function, jint futureCallbackType);
   /**
    * Call native future "andThen" for Function(P)->Future<R> with automatic unwrap
    * @param env JNI environment
    * @param thisFuture Caller object
    * @param pFuture Future pointer
    * @param function Function to callback
+   * @param futureCallbackType How to call the function (qi::FutureCallbackType)
+   * @return Created future
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function, jint futureCallbackType);
+  /**
+   * Call native future "andThen" once for a chain of Function(P)->R
+   * @param env JNI environment
+   * @param thisFuture Caller object
+   * @param pFuture Future pointer
+   * @param functions Functions to call in a row, each one receiving the result of the previous one
+   * @param futureCallbackType How to call the chain (qi::FutureCallbackType)
    * @return Created future
    */
-  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenChain(JNIEnv* env, jobject thisFuture, jlong pFuture, jobjectArray functions, jint futureCallbackType);
   /**
    * Call native future "then" for FutureFunction(Future<P>)->R
    * @param env JNI environment
    * @param thisFuture Caller object
    * @param pFuture Future pointer
    * @param futureFunction Function to callback
+   * @param futureCallbackType How to call the function (qi::FutureCallbackType)
    * @return Created future
    */
-  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction, jint futureCallbackType);
   /**
    * Call native future "then" for and FutureFunction(Future<P>)->Void
    * @param env JNI environment
    * @param thisFuture Caller object
    * @param pFuture Future pointer
    * @param futureFunction Function to callback
+   * @param futureCallbackType How to call the function (qi::FutureCallbackType)
    * @return Created future
    */
-  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction, jint futureCallbackType);
   /**
    * Call native future "then" for Function(Future<P>)->Future<R> with automatic unwrap
    * @param env JNI environment
    * @param thisFuture Caller object
    * @param pFuture Future pointer
    * @param function Function to callback
+   * @param futureCallbackType How to call the function (qi::FutureCallbackType)
    * @return Created future
    */
-  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction, jint futureCallbackType);
+  /**
+   * Create a future finished when all the given futures are finished successfully, or as soon as one of them fails
+   * @param env JNI environment
+   * @param cls Future class
+   * @param pFutures Futures pointers
+   * @param collectValues If true, the created future carries the list of the futures values
+   * @return Created future
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureWhenAll(JNIEnv* env, jclass cls, jlongArray pFutures, jboolean collectValues);
+  /**
+   * Create a future finished with the state of the first of the given futures to finish
+   * @param env JNI environment
+   * @param cls Future class
+   * @param pFutures Futures pointers
+   * @param keepValue If true, the created future carries the value of the first finished future
+   * @return Created future
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureWhenAny(JNIEnv* env, jclass cls, jlongArray pFutures, jboolean keepValue);
+  /**
+   * Create a future that takes the state of the given one, or fails with a timeout
+   * (and cancels the given one) if it is not finished before the given delay
+   * @param env JNI environment
+   * @param thisFuture Caller object
+   * @param pFuture Future pointer
+   * @param msecs Delay in milliseconds
+   * @return Created future
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureWithTimeout(JNIEnv* env, jobject thisFuture, jlong pFuture, jlong msecs);
 } // !extern "C"
 
+namespace qi
+{
+  class AnyValue;
+  template <typename T> class Future;
+}
+
+/**
+ * @brief extractValue Extract from AnyValue the embedded value and convert it to Java object
+ * @param env JNI environment
+ * @param value AnyValue that contains the value
+ * @return The extracted/converted Java object, a Java exception is pending if it fails
+ */
+jobject extractValue(JNIEnv *env, const qi::AnyValue& value);
+
+/**
+ * @brief whenAllFutures Combine futures, as com.aldebaran.qi.Future.waitAll and allOf do
+ * @param futures Futures to combine
+ * @param collectValues If true, the combined future carries the list of the futures values
+ * @return Future finished when all the futures are finished successfully, or as soon as one of them fails
+ */
+qi::Future<qi::AnyValue> whenAllFutures(const std::vector<qi::Future<qi::AnyValue>>& futures, bool collectValues);
+
 #endif //!_FUTURE_JNI_HPP_
@@ -0,0 +1,50 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#ifndef _JAVA_JNI_FUTURESTATE_HPP_
+#define _JAVA_JNI_FUTURESTATE_HPP_
+
+#include <jni.h>
+#include <qi/future.hpp>
+#include <qi/anyvalue.hpp>
+
+namespace qi {
+  namespace jni {
+
+    /**
+     * State words of the futures polled from Java, shared with Java through a direct ByteBuffer.
+     * Each word is a native-endian 32 bits integer: the 2 lowest bits hold the state
+     * (must match com.aldebaran.qi.Future), the other ones the generation of the slot,
+     * so that a future released before it finishes never writes in the slot of another one.
+     */
+    enum FutureStateWord
+    {
+      FutureStateWord_Running = 0,
+      FutureStateWord_Value = 1,
+      FutureStateWord_Error = 2,
+      FutureStateWord_Cancelled = 3,
+      FutureStateWord_Mask = 3
+    };
+
+    /**
+     * @brief acquireFutureState Give a state word to the future, updated when it finishes
+     * @return Index of the word in the shared buffer, or -1 if all of them are used
+     */
+    int acquireFutureState(const qi::Future<qi::AnyValue>& future);
+
+    /**
+     * @brief releaseFutureState Give back a state word obtained by acquireFutureState
+     */
+    void releaseFutureState(int slot);
+
+    /**
+     * @brief futureStateBuffer Direct ByteBuffer over all the state words
+     */
+    jobject futureStateBuffer(JNIEnv* env);
+  }// !jni
+}// !qi
+
+#endif // !_JAVA_JNI_FUTURESTATE_HPP_
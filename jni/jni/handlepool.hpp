@@ -0,0 +1,93 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#ifndef _JAVA_JNI_HANDLEPOOL_HPP_
+#define _JAVA_JNI_HANDLEPOOL_HPP_
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <qi/future.hpp>
+#include <qi/anyvalue.hpp>
+
+namespace qi {
+  namespace jni {
+
+    /**
+     * @brief The HandlePool class Slab allocator for the native objects handed to Java as pointers.
+     * Storage is allocated by slabs of SlabSize objects and recycled as soon as a handle is
+     * destroyed, instead of going back and forth to the heap for each future.
+     * Slabs are kept until the pool is destroyed.
+     */
+    template <typename T, std::size_t SlabSize = 256>
+    class HandlePool : boost::noncopyable
+    {
+    public:
+      template <typename... Args>
+      T* create(Args&&... args)
+      {
+        void* storage = acquire();
+        try
+        {
+          return new (storage) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+          giveBack(storage);
+          throw;
+        }
+      }
+
+      void destroy(T* handle)
+      {
+        if (!handle)
+          return;
+        handle->~T();
+        giveBack(handle);
+      }
+
+    private:
+      using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+      void* acquire()
+      {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_free.empty())
+        {
+          std::unique_ptr<Storage[]> slab(new Storage[SlabSize]);
+          _free.reserve(_free.size() + SlabSize);
+          for (std::size_t i = 0; i < SlabSize; ++i)
+            _free.push_back(&slab[i]);
+          _slabs.push_back(std::move(slab));
+        }
+        void* storage = _free.back();
+        _free.pop_back();
+        return storage;
+      }
+
+      void giveBack(void* storage)
+      {
+        boost::mutex::scoped_lock lock(_mutex);
+        _free.push_back(storage);
+      }
+
+      boost::mutex _mutex;
+      std::vector<void*> _free;
+      std::vector<std::unique_ptr<Storage[]>> _slabs;
+    };
+
+    // Future and promise handles given to Java, released by qiFutureDestroy and _destroyPromise
+    qi::Future<qi::AnyValue>*  newFuture(const qi::Future<qi::AnyValue>& future = qi::Future<qi::AnyValue>());
+    void                       deleteFuture(qi::Future<qi::AnyValue>* future);
+    qi::Promise<qi::AnyValue>* newPromise(qi::FutureCallbackType type);
+    void                       deletePromise(qi::Promise<qi::AnyValue>* promise);
+  }// !jni
+}// !qi
+
+#endif // !_JAVA_JNI_HANDLEPOOL_HPP_
@@ -38,6 +38,7 @@ extern jclass cls_boolean;
 
 extern jclass cls_future;
 extern jfieldID field_future_pointer;
+extern jfieldID field_future_shared;
 extern jclass cls_anyobject;
 extern jclass cls_tuple;
 
@@ -48,9 +49,16 @@ extern jclass cls_map;
 extern jclass cls_hashmap;
 
 extern jclass cls_object;
+extern jclass cls_objectArray;
 extern jclass cls_nativeTools;
 extern jmethodID method_NativeTools_callJava;
 
+// null when java.util.concurrent.CompletableFuture is not available (Java < 8, Android < 24)
+extern jclass cls_completableFuture;
+extern jmethodID method_CompletableFuture_complete;
+extern jmethodID method_CompletableFuture_completeExceptionally;
+extern jmethodID method_CompletableFuture_cancel;
+
 // JNI utils
 extern "C"
 {
@@ -61,6 +69,8 @@ extern "C"
 
 namespace qi {
   class AnyReference;
+  class AnyValue;
+  template <typename T> class Future;
   namespace jni {
 
     class JNIAttach
@@ -86,6 +96,11 @@ namespace qi {
     std::string javaSignature(const std::string& qiSignature);
     std::string qiSignature(jclass clazz);
     jobjectArray toJobjectArray(const std::vector<AnyReference> &values);
+    // Future of a com.aldebaran.qi.Future kept by native code, flags the Java future as shared
+    qi::Future<qi::AnyValue> sharedFuture(JNIEnv* env, jobject future);
+    // Register the native methods of the most used classes with RegisterNatives, see natives.cpp.
+    // Called once the library is loaded, by EmbeddedTools.initTypeSystem
+    void registerNatives(JNIEnv* env);
 
     template<typename R>
     struct Call
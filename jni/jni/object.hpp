@@ -17,12 +17,16 @@ extern "C"
 {
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_property(JNIEnv* env, jobject jobj, jlong pObj, jstring name);
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_setProperty(JNIEnv* env, jobject jobj, jlong pObj, jstring name, jobject property);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_properties(JNIEnv* env, jobject jobj, jlong pObj, jobjectArray names);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_setProperties(JNIEnv* env, jobject jobj, jlong pObj, jobjectArray names, jobjectArray values);
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_asyncCall(JNIEnv* env, jobject jobj, jlong pObj, jstring methodName, jobjectArray args);
   JNIEXPORT jstring JNICALL Java_com_aldebaran_qi_AnyObject_printMetaObject(JNIEnv* env, jobject jobj, jlong pObj);
   JNIEXPORT void JNICALL Java_com_aldebaran_qi_AnyObject_destroy(JNIEnv* env, jobject jobj, jlong pObj);
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connect(JNIEnv *env, jobject obj, jlong pObject, jstring method, jobject instance, jstring service, jstring event);
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_disconnect(JNIEnv *env, jobject jobj, jlong pObject, jlong subscriberId);
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connectSignal(JNIEnv *env, jobject obj, jlong pObject, jstring jSignalName, jobject listener);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connectSignalPrimitive(JNIEnv *env, jobject obj, jlong pObject, jstring jSignalName, jobject listener, jobject method, jstring jParameterDescriptors);
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connectSignalQueue(JNIEnv *env, jobject obj, jlong pObject, jstring jSignalName, jlong pQueue);
   JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_disconnectSignal(JNIEnv *env, jobject obj, jlong pObject, jlong subscriberId);
   JNIEXPORT void JNICALL Java_com_aldebaran_qi_AnyObject_post(JNIEnv *env, jobject obj, jlong pObject, jstring eventName, jobjectArray args);
   JNIEXPORT jobject JNICALL Java_com_aldebaran_qi_AnyObject_decodeJSON(JNIEnv* env, jclass cls, jstring str);
@@ -31,6 +31,62 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Promise__1getFuture
 JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setValue
   (JNIEnv *, jobject, jlong, jobject);
 
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setInt
+ * Signature: (JI)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setInt
+  (JNIEnv *, jobject, jlong, jint);
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setLong
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setLong
+  (JNIEnv *, jobject, jlong, jlong);
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setDouble
+ * Signature: (JD)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setDouble
+  (JNIEnv *, jobject, jlong, jdouble);
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setString
+ * Signature: (JLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setString
+  (JNIEnv *, jobject, jlong, jstring);
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setBytes
+ * Signature: (J[B)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setBytes
+  (JNIEnv *, jobject, jlong, jbyteArray);
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setVoid
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setVoid
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setValues
+ * Signature: ([J[Ljava/lang/Object;)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setValues
+  (JNIEnv *, jclass, jlongArray, jobjectArray);
+
 /*
  * Class:     com_aldebaran_qi_Promise
  * Method:    _setError
@@ -51,7 +107,7 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setOnCancel
   (JNIEnv *, jobject, jlong, jobject);
 
 JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1destroyPromise
-  (JNIEnv *, jobject, jlong);
+  (JNIEnv *, jclass, jlong);
 
 #ifdef __cplusplus
 }
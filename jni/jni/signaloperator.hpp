@@ -0,0 +1,67 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#ifndef _JAVA_JNI_SIGNALOPERATOR_HPP_
+#define _JAVA_JNI_SIGNALOPERATOR_HPP_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <qi/anyvalue.hpp>
+#include <qi/clock.hpp>
+
+namespace qi {
+  namespace jni {
+
+    /**
+     * Kinds of signal operators, must match com.aldebaran.qi.SignalOperators
+     */
+    enum SignalOperatorKind
+    {
+      SignalOperatorKind_Decimate = 0,
+      SignalOperatorKind_RateLimit = 1,
+      SignalOperatorKind_WindowMean = 2,
+      SignalOperatorKind_WindowMin = 3,
+      SignalOperatorKind_WindowMax = 4,
+      SignalOperatorKind_Deadband = 5
+    };
+
+    /**
+     * Reduce the stream of emissions of a signal before they are converted to Java.
+     * Not thread-safe: emissions must be applied one at a time.
+     */
+    class SignalOperator
+    {
+    public:
+      virtual ~SignalOperator() {}
+
+      /**
+       * @brief apply Reduce an emission
+       * @param args Arguments of the emission, an operator may replace them by values it adds to storage
+       * @param storage Owns the replaced arguments until the emission is queued
+       * @param time Time of the emission
+       * @return false to drop the emission
+       */
+      virtual bool apply(std::vector<qi::AnyReference>& args,
+                         std::deque<qi::AnyValue>& storage,
+                         qi::SteadyClock::time_point time) = 0;
+    };
+
+    using SignalOperatorPtr = std::unique_ptr<SignalOperator>;
+
+    /**
+     * @brief makeSignalOperator Create an operator from its kind and its parameter
+     * @param kind A SignalOperatorKind
+     * @param parameter Number of emissions for Decimate and the window ones, frequency in Hz for RateLimit,
+     * threshold for Deadband
+     * @throw std::invalid_argument if the kind or the parameter is not valid
+     */
+    SignalOperatorPtr makeSignalOperator(int kind, double parameter);
+  }// !jni
+}// !qi
+
+#endif // !_JAVA_JNI_SIGNALOPERATOR_HPP_
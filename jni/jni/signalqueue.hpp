@@ -0,0 +1,111 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#ifndef _JAVA_JNI_SIGNALQUEUE_HPP_
+#define _JAVA_JNI_SIGNALQUEUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <jni.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <qi/anyvalue.hpp>
+#include <qi/clock.hpp>
+
+#include <jnitools.hpp>
+#include <signaloperator.hpp>
+
+namespace qi {
+  namespace jni {
+
+    /**
+     * Queue the emissions of a signal and deliver them to a com.aldebaran.qi.QiSignalBatchListener,
+     * from the event loop, in batches of at most maxBatchSize emissions.
+     * A batch is delivered as soon as it is full, or once its oldest emission waited for maxLatency.
+     * Batches are delivered one at a time, in the order of the emissions.
+     *
+     * If capacity is not 0, at most capacity emissions wait for a slow listener:
+     * the oldest ones are dropped to make room for the new ones.
+     *
+     * The operators reduce the emissions before they are queued, in order.
+     */
+    class SignalQueue : public std::enable_shared_from_this<SignalQueue>
+    {
+    public:
+      SignalQueue(JNIEnv* env, jobject listener, std::size_t maxBatchSize, qi::Duration maxLatency, std::size_t capacity,
+                  std::vector<SignalOperatorPtr> operators = std::vector<SignalOperatorPtr>());
+
+      /**
+       * @brief push Queue an emission, called by the signal subscriber
+       */
+      void push(const std::vector<qi::AnyReference>& args);
+
+      /**
+       * @brief dropped Number of emissions dropped because the queue was full
+       */
+      std::uint64_t dropped() const;
+
+      /**
+       * @brief close Drop the pending emissions and stop delivering.
+       * Waits for the batch being delivered, unless called by its listener.
+       */
+      void close();
+
+    private:
+      struct Emission
+      {
+        qi::SteadyClock::time_point time;
+        std::vector<qi::AnyValue> args;
+      };
+      using Lock = boost::mutex::scoped_lock;
+
+      bool ready() const;
+      void schedule(Lock& lock);
+      void deliver(Lock& lock);
+      void toJava(const std::vector<Emission>& batch);
+
+      SharedGlobalRef _listener;
+      jmethodID _onSignalsReceived;
+      const std::size_t _maxBatchSize;
+      const qi::Duration _maxLatency;
+      // 0 if unbounded
+      const std::size_t _capacity;
+      std::atomic<std::uint64_t> _dropped;
+
+      // applies the operators to one emission at a time
+      boost::mutex _operatorsMutex;
+      std::vector<SignalOperatorPtr> _operators;
+
+      boost::mutex _mutex;
+      std::deque<Emission> _pending;
+      // a delivery is queued in the event loop
+      bool _flushQueued;
+      // a delivery is delayed until the oldest pending emission is too old
+      bool _timerArmed;
+      // a batch is being delivered to Java, by _deliveringThread
+      bool _delivering;
+      std::thread::id _deliveringThread;
+      boost::condition_variable _delivered;
+      // nothing is delivered once closed
+      bool _closed;
+    };
+
+    // Handle given to Java, the signal subscriber keeps its own reference
+    using SignalQueuePtr = std::shared_ptr<SignalQueue>;
+
+    inline SignalQueuePtr& signalQueueFromPointer(jlong pQueue)
+    {
+      return *reinterpret_cast<SignalQueuePtr*>(pQueue);
+    }
+  }// !jni
+}// !qi
+
+#endif // !_JAVA_JNI_SIGNALQUEUE_HPP_
@@ -0,0 +1,51 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#ifndef _SIGNALQUEUE_JNI_HPP_
+#define _SIGNALQUEUE_JNI_HPP_
+
+#include <jni.h>
+
+extern "C"
+{
+  /**
+   * Create a signal queue delivering to the given listener
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param listener QiSignalBatchListener receiving the emissions
+   * @param maxBatchSize Maximum number of emissions per batch
+   * @param maxLatencyMicros Maximum time an emission waits for its batch, in microseconds
+   * @param capacity Maximum number of pending emissions, the oldest ones are dropped beyond. 0 for no limit
+   * @param operatorKinds Kinds of the operators applied to the emissions before they are queued, in order
+   * @param operatorParameters Parameter of each operator
+   * @return Signal queue pointer, 0 if an operator is not valid
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueCreate(JNIEnv* env, jobject obj, jobject listener, jint maxBatchSize, jlong maxLatencyMicros, jint capacity,
+                                                                                jintArray operatorKinds, jdoubleArray operatorParameters);
+  /**
+   * Number of emissions dropped because the queue was full
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Signal queue pointer
+   */
+  JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueDropped(JNIEnv* env, jobject obj, jlong pQueue);
+  /**
+   * Drop the pending emissions and stop delivering, once the batch being delivered returned
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Signal queue pointer
+   */
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueClose(JNIEnv* env, jobject obj, jlong pQueue);
+  /**
+   * Release the Java handle of the signal queue. It lives as long as a signal delivers to it
+   * @param env JNI environment
+   * @param obj Caller object
+   * @param pQueue Signal queue pointer
+   */
+  JNIEXPORT void JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueDestroy(JNIEnv* env, jobject obj, jlong pQueue);
+} // !extern "C"
+
+#endif //!_SIGNALQUEUE_JNI_HPP_
@@ -7,6 +7,10 @@
 ** See COPYING for the license
 */
 
+#include <unordered_map>
+
+#include <boost/thread/mutex.hpp>
+
 #include <qi/log.hpp>
 #include <qi/future.hpp>
 
@@ -17,11 +21,58 @@
 #include <callbridge.hpp>
 #include <jobjectconverter.hpp>
 #include <jnitools.hpp>
+#include <handlepool.hpp>
 
 qiLogCategory("qimessaging.jni");
 
 MethodInfoHandler gInfoHandler;
 
+namespace
+{
+  /**
+   * @brief The AbandonedCalls struct: futures abandoned by their caller (Future.cancelOnCollect()),
+   * by shared state, whose result is dropped when it arrives. Each entry keeps its future alive,
+   * so that its state is not reused, until it finishes.
+   */
+  struct AbandonedCalls
+  {
+    boost::mutex mutex;
+    std::unordered_map<const void*, qi::Future<qi::AnyValue>> futures;
+  };
+
+  // Never destroyed: finalizers may abandon futures while the library unloads
+  AbandonedCalls& abandonedCalls()
+  {
+    static auto* calls = new AbandonedCalls();
+    return *calls;
+  }
+
+  bool isAbandoned(const qi::Future<qi::AnyValue>& future)
+  {
+    AbandonedCalls& calls = abandonedCalls();
+    boost::mutex::scoped_lock lock(calls.mutex);
+    return calls.futures.count(future.uniqueId()) != 0;
+  }
+}
+
+void abandonCall(qi::Future<qi::AnyValue> future)
+{
+  AbandonedCalls& calls = abandonedCalls();
+  const void* id = future.uniqueId();
+  {
+    boost::mutex::scoped_lock lock(calls.mutex);
+    if (!calls.futures.emplace(id, future).second)
+      return;
+  }
+
+  future.connect([id](const qi::Future<qi::AnyValue>&) {
+    AbandonedCalls& calls = abandonedCalls();
+    boost::mutex::scoped_lock lock(calls.mutex);
+    calls.futures.erase(id);
+  }, qi::FutureCallbackType_Sync);
+  future.cancel();
+}
+
 /**
  * @brief call_from_java Helper function to call qiMessaging method with Java arguments
  * @param env JNI environment given by JVM.
@@ -73,14 +124,21 @@ qi::Future<qi::AnyValue>* call_from_java(JNIEnv *env, qi::AnyObject object, cons
       {
         promise.setCanceled();
       }
+      else if (promise.isCancelRequested() && isAbandoned(promise.future()))
+      {
+        // The caller abandoned the call before its result arrived: drop it
+        // instead of keeping it for a conversion that will never happen.
+        // Callers that only requested the cancellation may still want it.
+        result.value().destroy();
+        promise.setCanceled();
+      }
       else
       {
         promise.setValue(qi::AnyValue(result.value(), false, true));
       }
     });
 
-    std::unique_ptr<qi::Future<qi::AnyValue>> fut ( new auto(promise.future()) );
-    return fut.release();
+    return qi::jni::newFuture(promise.future());
 
   } catch (std::runtime_error &e)
   {
@@ -102,34 +160,61 @@ jvalue object2value(jobject object)
 }
 
 /**
- * @brief call_to_java Heller function to call Java methods.
- * @param signature qitype signature formated
- * @param data pointer on a qi_method_info (which hold Java object class and reference)
+ * @brief javaExceptionMessage Extract the message of a Java exception
+ * @param env JNI environment
+ * @param exc Exception thrown by the Java side
+ * @return The exception message
+ */
+static std::string javaExceptionMessage(JNIEnv* env, jthrowable exc)
+{
+  jclass throwable_class = env->FindClass("java/lang/Throwable");
+  jmethodID getMessage =
+    env->GetMethodID(throwable_class,
+        "getMessage",
+        "()Ljava/lang/String;");
+
+  jstring msg = (jstring)env->CallObjectMethod(exc, getMessage);
+  if (!msg)
+  {
+    // exceptions thrown without message, e.g. NullPointerException: at least give the class name
+    jmethodID toString =
+      env->GetMethodID(throwable_class,
+          "toString",
+          "()Ljava/lang/String;");
+    msg = (jstring)env->CallObjectMethod(exc, toString);
+  }
+  env->DeleteLocalRef(throwable_class);
+  if (!msg || env->ExceptionCheck())
+  {
+    env->ExceptionClear();
+    return "Unknown Java exception";
+  }
+
+  const char* data = env->GetStringUTFChars(msg, 0);
+  std::string tmp = std::string(data);
+  env->ReleaseStringUTFChars(msg, data);
+  env->DeleteLocalRef(msg);
+  return tmp;
+}
+
+/**
+ * @brief invoke_java Convert parameters and call the Java method described by a qi_method_info
+ * through NativeTools.callJava.
+ * @param env JNI environment attached to the current thread
+ * @param info Java object class and reference
+ * @param sigInfo qitype signature, split
+ * @param javaSignature Java signature of the method to call
  * @param params parameters to forward to called method
- * @return
+ * @return The local reference returned by the Java method, the caller must check for pending exceptions
  */
-qi::AnyReference call_to_java(std::string signature, void* data, const qi::GenericFunctionParameters& params)
+static jobject invoke_java(JNIEnv* env, qi_method_info* info, const std::vector<std::string>& sigInfo,
+                           const std::string& javaSignature, const qi::GenericFunctionParameters& params)
 {
-  qi::AnyReference res;
   // Arguments given to Java to call NativeTools.callJava method
   // NativeTools.callJava(Object instance, String methodName, String methodSignature, Object[] methodArguments):Object
-  jvalue*             callJavaArguments = new jvalue[4];
+  jvalue              callJavaArguments[4];
   int                 index = 0;
-  JNIEnv*             env = 0;
-  qi_method_info*     info = reinterpret_cast<qi_method_info*>(data);
   jclass              cls = 0;
-  std::vector<std::string>  sigInfo = qi::signatureSplit(signature);
-
-  qi::jni::JNIAttach attach;
-  env = attach.get();
-
-  // Check value of method info structure
-  if (info == 0)
-  {
-    qiLogError() << "Internal method informations are not valid";
-    throwNewException(env, "Internal method informations are not valid");
-    return res;
-  }
 
   // Translate parameters from AnyValues to jobjects
   qi::GenericFunctionParameters::const_iterator it = params.begin();
@@ -172,13 +257,49 @@ qi::AnyReference call_to_java(std::string signature, void* data, const qi::Gener
     throw std::runtime_error("Service class not found");
   }
 
-  std::string javaSignature = toJavaSignature(signature);
   callJavaArguments[0] = object2value(info->instance);
   callJavaArguments[1] = object2value(env->NewStringUTF(sigInfo[1].c_str()));
   callJavaArguments[2] = object2value(env->NewStringUTF(javaSignature.c_str()));
   callJavaArguments[3] = object2value(arguments);
   jobject valueResult = env->CallStaticObjectMethodA(cls_nativeTools, method_NativeTools_callJava, callJavaArguments);
 
+  // Release instance clazz
+  qi::jni::releaseClazz(cls);
+  // callJavaArguments[0].l is not released by purpose: it is info->instance
+  qi::jni::releaseObject(callJavaArguments[1].l);
+  qi::jni::releaseObject(callJavaArguments[2].l);
+  qi::jni::releaseObject(callJavaArguments[3].l);
+
+  return valueResult;
+}
+
+/**
+ * @brief call_to_java Heller function to call Java methods.
+ * @param signature qitype signature formated
+ * @param data pointer on a qi_method_info (which hold Java object class and reference)
+ * @param params parameters to forward to called method
+ * @return
+ */
+qi::AnyReference call_to_java(std::string signature, void* data, const qi::GenericFunctionParameters& params)
+{
+  qi::AnyReference res;
+  JNIEnv*             env = 0;
+  qi_method_info*     info = reinterpret_cast<qi_method_info*>(data);
+  std::vector<std::string>  sigInfo = qi::signatureSplit(signature);
+
+  qi::jni::JNIAttach attach;
+  env = attach.get();
+
+  // Check value of method info structure
+  if (info == 0)
+  {
+    qiLogError() << "Internal method informations are not valid";
+    throwNewException(env, "Internal method informations are not valid");
+    return res;
+  }
+
+  jobject valueResult = invoke_java(env, info, sigInfo, toJavaSignature(signature), params);
+
   if (sigInfo[0] == "" || sigInfo[0] == "v")
   {
     res = qi::AnyReference(qi::typeOf<void>());
@@ -196,31 +317,65 @@ qi::AnyReference call_to_java(std::string signature, void* data, const qi::Gener
   if (jthrowable exc = env->ExceptionOccurred())
   {
     env->ExceptionClear();
+    throw std::runtime_error(javaExceptionMessage(env, exc));
+  }
 
-    jclass throwable_class = env->FindClass("java/lang/Throwable");
-    jmethodID getMessage =
-      env->GetMethodID(throwable_class,
-          "getMessage",
-          "()Ljava/lang/String;");
+  return res;
+}
 
-    jstring msg = (jstring)env->CallObjectMethod(exc, getMessage);
+/**
+ * @brief call_to_java_async Helper function to call Java methods returning a com.aldebaran.qi.Future.
+ * The native future embedded in the Java one is handed to libqi as is, so the calling qi thread
+ * is released as soon as the Java method returns, without waiting nor converting the result.
+ * @param signature qitype signature formated
+ * @param data pointer on a qi_method_info (which hold Java object class and reference)
+ * @param params parameters to forward to called method
+ * @return A reference on a qi::Future<qi::AnyValue>
+ */
+qi::AnyReference call_to_java_async(std::string signature, void* data, const qi::GenericFunctionParameters& params)
+{
+  JNIEnv*             env = 0;
+  qi_method_info*     info = reinterpret_cast<qi_method_info*>(data);
+  std::vector<std::string>  sigInfo = qi::signatureSplit(signature);
 
-    const char* data = env->GetStringUTFChars(msg, 0);
-    std::string tmp = std::string(data);
-    env->ReleaseStringUTFChars(msg, data);
+  qi::jni::JNIAttach attach;
+  env = attach.get();
 
-    throw std::runtime_error(tmp);
+  // Check value of method info structure
+  if (info == 0)
+  {
+    qiLogError() << "Internal method informations are not valid";
+    throw std::runtime_error("Internal method informations are not valid");
   }
 
-  // Release instance clazz
-  qi::jni::releaseClazz(cls);
-  // callJavaArguments[0].l is not released by purpose: it is info->instance
-  qi::jni::releaseObject(callJavaArguments[1].l);
-  qi::jni::releaseObject(callJavaArguments[2].l);
-  qi::jni::releaseObject(callJavaArguments[3].l);
-  delete[] callJavaArguments;
+  jobject valueResult = invoke_java(env, info, sigInfo, toJavaSignatureWithFuture(signature), params);
 
-  return res;
+  // The storage is owned by the returned reference, libqi destroys it once the call is answered
+  qi::Future<qi::AnyValue>* result = nullptr;
+
+  if (jthrowable exc = env->ExceptionOccurred())
+  {
+    env->ExceptionClear();
+    result = new qi::Future<qi::AnyValue>(qi::makeFutureError<qi::AnyValue>(javaExceptionMessage(env, exc)));
+  }
+  else if (env->IsSameObject(valueResult, NULL))
+  {
+    result = new qi::Future<qi::AnyValue>(qi::Future<qi::AnyValue>(qi::AnyValue(qi::typeOf<void>())));
+  }
+  else
+  {
+    try
+    {
+      result = new qi::Future<qi::AnyValue>(qi::jni::sharedFuture(env, valueResult));
+    }
+    catch (const std::exception& e)
+    {
+      result = new qi::Future<qi::AnyValue>(qi::makeFutureError<qi::AnyValue>(e.what()));
+    }
+    qi::jni::releaseObject(valueResult);
+  }
+
+  return qi::AnyReference::from(*result);
 }
 
 /**
@@ -0,0 +1,267 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <qi/anyvalue.hpp>
+#include <qi/future.hpp>
+
+#include <jnitools.hpp>
+#include <future_jni.hpp>
+#include <completionqueue_jni.hpp>
+
+namespace
+{
+  // Must match the constants of com.aldebaran.qi.CompletionQueue
+  enum CompletionState
+  {
+    CompletionState_Value = 0,
+    CompletionState_Error = 1,
+    CompletionState_Cancelled = 2
+  };
+
+  struct Completion
+  {
+    Completion* next;
+    jlong tag;
+    qi::Future<qi::AnyValue> future;
+  };
+
+  /**
+   * Multiple producers (the future callbacks) push completions on a lock-free
+   * stack, the consumer takes the whole stack at once and keeps it in order.
+   * The mutex and condition are only used when a consumer waits for completions.
+   */
+  class CompletionQueue
+  {
+  public:
+    CompletionQueue()
+      : _head(nullptr)
+      , _waiters(0)
+      , _closed(false)
+    {
+    }
+
+    ~CompletionQueue()
+    {
+      for (Completion* completion : _ready)
+        delete completion;
+
+      Completion* completion = _head.exchange(nullptr);
+      while (completion)
+      {
+        Completion* next = completion->next;
+        delete completion;
+        completion = next;
+      }
+    }
+
+    void push(Completion* completion)
+    {
+      Completion* head = _head.load(std::memory_order_relaxed);
+      do
+      {
+        completion->next = head;
+      } while (!_head.compare_exchange_weak(head, completion));
+
+      if (_waiters.load() > 0)
+      {
+        boost::mutex::scoped_lock lock(_mutex);
+        _condition.notify_all();
+      }
+    }
+
+    /**
+     * @brief close Wake up the consumers and make them fail, now and from then on
+     */
+    void close()
+    {
+      _closed = true;
+      boost::mutex::scoped_lock lock(_mutex);
+      _condition.notify_all();
+    }
+
+    /**
+     * @brief pop Take up to max completions, in the order they were pushed
+     * @param completions Receives the completions, the caller becomes their owner
+     * @param max Maximum number of completions to take
+     * @param msecs Maximum time to wait if there is none, negative for infinite
+     * @return false if the queue was closed
+     */
+    bool pop(std::vector<Completion*>& completions, std::size_t max, jlong msecs)
+    {
+      boost::mutex::scoped_lock consumerLock(_consumerMutex);
+
+      collect();
+      if (_ready.empty() && msecs != 0)
+      {
+        wait(msecs);
+        collect();
+      }
+
+      if (_closed)
+        return false;
+
+      while (!_ready.empty() && completions.size() < max)
+      {
+        completions.push_back(_ready.front());
+        _ready.pop_front();
+      }
+      return true;
+    }
+
+  private:
+    // Move the pushed completions to the ready list, oldest first
+    void collect()
+    {
+      Completion* completion = _head.exchange(nullptr, std::memory_order_acquire);
+      Completion* oldest = nullptr;
+      while (completion)
+      {
+        Completion* next = completion->next;
+        completion->next = oldest;
+        oldest = completion;
+        completion = next;
+      }
+
+      for (; oldest; oldest = oldest->next)
+        _ready.push_back(oldest);
+    }
+
+    void wait(jlong msecs)
+    {
+      boost::unique_lock<boost::mutex> lock(_mutex);
+      ++_waiters;
+
+      const boost::system_time deadline = boost::get_system_time() + boost::posix_time::milliseconds(msecs);
+      while (_head.load() == nullptr && !_closed)
+      {
+        if (msecs < 0)
+          _condition.wait(lock);
+        else if (!_condition.timed_wait(lock, deadline))
+          break;
+      }
+
+      --_waiters;
+    }
+
+    std::atomic<Completion*> _head;
+    std::atomic<int> _waiters;
+    std::atomic<bool> _closed;
+    boost::mutex _mutex;
+    boost::condition_variable _condition;
+    boost::mutex _consumerMutex;
+    std::deque<Completion*> _ready;
+  };
+
+  // Registered futures keep the queue alive until they finish
+  using CompletionQueuePtr = std::shared_ptr<CompletionQueue>;
+
+  CompletionQueuePtr& queueFromPointer(jlong pQueue)
+  {
+    return *reinterpret_cast<CompletionQueuePtr*>(pQueue);
+  }
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueCreate(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj))
+{
+  return reinterpret_cast<jlong>(new CompletionQueuePtr(std::make_shared<CompletionQueue>()));
+}
+
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueRegister(JNIEnv* env, jobject QI_UNUSED(obj), jlong pQueue, jobject future, jlong tag)
+{
+  CompletionQueuePtr queue = queueFromPointer(pQueue);
+  qi::Future<qi::AnyValue> watched;
+
+  try
+  {
+    watched = qi::jni::sharedFuture(env, future);
+  }
+  catch (const std::exception& e)
+  {
+    throwNewRuntimeException(env, e.what());
+    return;
+  }
+
+  watched.connect([queue, tag](const qi::Future<qi::AnyValue>& finished) {
+    queue->push(new Completion{nullptr, tag, finished});
+  }, qi::FutureCallbackType_Sync);
+}
+
+JNIEXPORT jint JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueDrain(JNIEnv* env, jobject QI_UNUSED(obj), jlong pQueue, jlongArray tags, jintArray states, jobjectArray results, jlong msecs)
+{
+  const std::size_t max = static_cast<std::size_t>(env->GetArrayLength(tags));
+  if (max == 0)
+    return 0;
+
+  std::vector<Completion*> completions;
+  completions.reserve(max);
+  // keep the queue alive while waiting, even if the Java one is closed meanwhile
+  CompletionQueuePtr queue = queueFromPointer(pQueue);
+  if (!queue->pop(completions, max, msecs))
+  {
+    throwNew(env, "java/lang/IllegalStateException", "CompletionQueue closed");
+    return 0;
+  }
+
+  std::vector<jlong> tagValues(completions.size());
+  std::vector<jint> stateValues(completions.size());
+  for (std::size_t index = 0; index < completions.size(); ++index)
+  {
+    Completion* completion = completions[index];
+    const qi::Future<qi::AnyValue>& future = completion->future;
+    jobject result = nullptr;
+
+    tagValues[index] = completion->tag;
+    if (future.hasValue(0))
+    {
+      stateValues[index] = CompletionState_Value;
+      result = extractValue(env, future.value(0));
+      if (env->ExceptionCheck())
+      {
+        // Report the conversion failure with the completion instead of losing the following ones
+        env->ExceptionClear();
+        stateValues[index] = CompletionState_Error;
+        result = env->NewStringUTF("cannot convert the future value");
+      }
+    }
+    else if (future.hasError(0))
+    {
+      stateValues[index] = CompletionState_Error;
+      result = env->NewStringUTF(future.error(0).c_str());
+    }
+    else
+    {
+      stateValues[index] = CompletionState_Cancelled;
+    }
+
+    env->SetObjectArrayElement(results, static_cast<jsize>(index), result);
+    if (result)
+      env->DeleteLocalRef(result);
+    delete completion;
+  }
+
+  const jsize count = static_cast<jsize>(completions.size());
+  env->SetLongArrayRegion(tags, 0, count, tagValues.data());
+  env->SetIntArrayRegion(states, 0, count, stateValues.data());
+  return count;
+}
+
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueClose(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pQueue)
+{
+  queueFromPointer(pQueue)->close();
+}
+
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueDestroy(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pQueue)
+{
+  delete &queueFromPointer(pQueue);
+}
@@ -7,9 +7,17 @@
 ** See COPYING for the license
 */
 
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include <boost/thread/mutex.hpp>
 #include <qi/anyvalue.hpp>
+#include <qi/eventloop.hpp>
 
 #include <jnitools.hpp>
+#include <handlepool.hpp>
+#include <futurestate.hpp>
 #include <futurehandler.hpp>
 #include <future_jni.hpp>
 #include <callbridge.hpp>
@@ -20,29 +28,100 @@ qiLogCategory("qimessaging.java");
 // *** TOOLS ***
 // *************
 
+/**
+ * Error message of the futures that did not finish before their deadline
+ */
+static const std::string futureTimeoutError = "Future deadline expired";
+
+namespace
+{
+    using DeadlineFlag = std::shared_ptr<std::atomic<bool>>;
+
+    /**
+     * Expiry flags of the future handles created by qiFutureWithTimeout: an expired deadline is
+     * reported as a TimeoutException without looking at the error message, which may come from anywhere
+     */
+    class DeadlineRegistry
+    {
+    public:
+        DeadlineRegistry()
+            : _size(0)
+        {
+        }
+
+        DeadlineFlag add(const qi::Future<qi::AnyValue>* handle)
+        {
+            DeadlineFlag flag = std::make_shared<std::atomic<bool>>(false);
+            boost::mutex::scoped_lock lock(_mutex);
+            _flags[handle] = flag;
+            _size = _flags.size();
+            return flag;
+        }
+
+        // Null if the handle has no deadline
+        DeadlineFlag find(const qi::Future<qi::AnyValue>* handle)
+        {
+            if (_size.load() == 0)
+                return DeadlineFlag();
+            boost::mutex::scoped_lock lock(_mutex);
+            auto it = _flags.find(handle);
+            return it != _flags.end() ? it->second : DeadlineFlag();
+        }
+
+        bool expired(const qi::Future<qi::AnyValue>* handle)
+        {
+            DeadlineFlag flag = find(handle);
+            return flag && flag->load();
+        }
+
+        // Called for every destroyed handle, hence the lock-free check first
+        void remove(const qi::Future<qi::AnyValue>* handle)
+        {
+            if (_size.load() == 0)
+                return;
+            boost::mutex::scoped_lock lock(_mutex);
+            _flags.erase(handle);
+            _size = _flags.size();
+        }
+
+    private:
+        boost::mutex _mutex;
+        std::unordered_map<const qi::Future<qi::AnyValue>*, DeadlineFlag> _flags;
+        std::atomic<std::size_t> _size;
+    };
+
+    // Never destroyed: finalizers may release handles while the library unloads
+    DeadlineRegistry& deadlines()
+    {
+        static auto* registry = new DeadlineRegistry();
+        return *registry;
+    }
+}
+
 /**
  * @brief extractValue Extract from AnyValue the embedded value and convert it to Java object
  * @param env JNI environment
  * @param value AnyValue that contains the value
  * @return The extracted/converted Java object
  */
-static jobject extractValue(JNIEnv *env, const qi::AnyValue& value)
+jobject extractValue(JNIEnv *env, const qi::AnyValue& value)
 {
     try
     {
+        static const qi::TypeInfo& anyValueInfo = qi::typeOf<qi::AnyValue>()->info();
         qi::AnyReference arRes = value.asReference();
-        qi::TypeInterface* typeInterface = arRes.type();
 
-        if(typeInterface == nullptr)
+        //If the AnyReference contains an AnyValue,
+        //Then we get the value from this AnyValue
+        while (arRes.type() != nullptr && arRes.type()->info() == anyValueInfo)
         {
-            return nullptr;
+            arRes = reinterpret_cast<qi::AnyValue*>(arRes.rawValue())->asReference();
         }
 
-        if(typeInterface->info() == qi::typeOf<qi::AnyValue>()->info())
+        if(arRes.type() == nullptr || arRes.kind() == qi::TypeKind_Void)
         {
-            //If the AnyReference contains an AnyValue,
-            //Then we get the value from this AnyValue
-            return extractValue(env, *reinterpret_cast<qi::AnyValue*>(arRes.rawValue()));
+            //Void is given to Java as null
+            return nullptr;
         }
 
         std::pair<qi::AnyReference, bool> converted = arRes.convert(qi::typeOf<jobject>());
@@ -108,6 +187,11 @@ static jobject obtainValue(JNIEnv *env, qi::Future<qi::AnyValue>* future, jint m
             throwNewCancellationException(env, "native future cancelled");
             break;
         case qi::FutureException::ExceptionState_FutureUserError:
+            if (deadlines().expired(future))
+            {
+                throwNewTimeoutException(env, "native future deadline expired");
+                break;
+            }
             throwNewExecutionException(env, createNewQiException(env, e.what()));
             break;
         default:
@@ -191,14 +275,13 @@ static qi::Future<qi::AnyValue> obtainFutureCfromFutureJava(JNIEnv *env, jobject
         future = futureOfNull(env);
     }
 
-    // Obtain the C++ pointer embed in Future Java
-    jlong pointer = env->GetLongField(future, field_future_pointer);
+    //Obtain the C++ Future linked to the pointer embed in Future Java
+    qi::Future<qi::AnyValue> result = qi::jni::sharedFuture(env, future);
 
     //Check if exception happened on Java side
     checkJavaExceptionAndReport(env);
 
-    //Obtain the C++ Future linked to the pointer
-    return *reinterpret_cast<qi::Future<qi::AnyValue>*>(pointer);
+    return result;
 }
 
 /**
@@ -211,6 +294,74 @@ static qi::Future<qi::AnyValue>* futureFromPointer(jlong pointer)
     return reinterpret_cast<qi::Future<qi::AnyValue>*>(pointer);
 }
 
+/**
+ * @brief futuresFromPointers Get the futures that lie behind given pointers addresses
+ * @param env JNI environment
+ * @param pointers Java array of pointers addresses
+ * @return Copies of the futures
+ */
+static std::vector<qi::Future<qi::AnyValue>> futuresFromPointers(JNIEnv *env, jlongArray pointers)
+{
+    std::vector<qi::Future<qi::AnyValue>> futures;
+    const jsize size = env->GetArrayLength(pointers);
+    jlong *elements = env->GetLongArrayElements(pointers, nullptr);
+    futures.reserve(size);
+
+    for (jsize i = 0; i < size; ++i)
+    {
+        futures.push_back(*futureFromPointer(elements[i]));
+    }
+
+    env->ReleaseLongArrayElements(pointers, elements, JNI_ABORT);
+    return futures;
+}
+
+/**
+ * @brief newCombinedPromise Create a promise that requests the cancellation of all given futures
+ * when its own cancellation is requested
+ * @param futures Futures combined by the promise
+ * @return The promise
+ */
+static qi::Promise<qi::AnyValue> newCombinedPromise(const std::vector<qi::Future<qi::AnyValue>> &futures)
+{
+    return qi::Promise<qi::AnyValue>{[futures](qi::Promise<qi::AnyValue>) mutable {
+        for (auto &future : futures)
+        {
+            future.cancel();
+        }
+    }};
+}
+
+/**
+ * @brief newFuturePointer Allocate a future handle to give to Java
+ * @param future Future to hold
+ * @return Pointer of the allocated future
+ */
+static jlong newFuturePointer(const qi::Future<qi::AnyValue> &future)
+{
+    return reinterpret_cast<jlong>(qi::jni::newFuture(future));
+}
+
+/**
+ * @brief The WhenAllState struct: shared by the callbacks of the futures combined by whenAll
+ */
+struct WhenAllState
+{
+    WhenAllState(std::size_t count, qi::Promise<qi::AnyValue> promise, bool collectValues)
+        : running(count)
+        , stopped(false)
+        , values(collectValues ? count : 0)
+        , promise(std::move(promise))
+    {
+    }
+
+    std::atomic<std::size_t> running;
+    std::atomic<bool> stopped;
+    // each callback only writes its own slot, read once all of them are done
+    std::vector<qi::AnyValue> values;
+    qi::Promise<qi::AnyValue> promise;
+};
+
 // ****************
 // *** Functors ***
 // ****************
@@ -242,6 +393,63 @@ struct CallbackFunctor
     }
 };
 
+/**
+ * @brief The CompletableFutureFunctor struct: completes a java.util.concurrent.CompletableFuture
+ * with the state of the future, through the method IDs cached by init_classes
+ */
+struct CompletableFutureFunctor
+{
+    qi::jni::SharedGlobalRef _completableFuture;
+    // set if the future has a deadline
+    DeadlineFlag _expired;
+    void operator()(const qi::Future<qi::AnyValue> &future) const
+    {
+        jobject completableFuture = _completableFuture.get();
+
+        qi::jni::JNIAttach attach;
+        JNIEnv *env = attach.get();
+
+        if (future.hasValue())
+        {
+            jobject value = extractValue(env, future.value());
+            jthrowable conversionError = env->ExceptionOccurred();
+
+            if (conversionError)
+            {
+                env->ExceptionClear();
+                env->CallBooleanMethod(completableFuture, method_CompletableFuture_completeExceptionally, conversionError);
+                env->DeleteLocalRef(conversionError);
+            }
+            else
+            {
+                env->CallBooleanMethod(completableFuture, method_CompletableFuture_complete, value);
+            }
+
+            env->DeleteLocalRef(value);
+        }
+        else if (future.hasError())
+        {
+            // same exceptions as Future.get(…)
+            jthrowable error = _expired && _expired->load()
+                    ? createNewException(env, "java/util/concurrent/TimeoutException", "native future deadline expired")
+                    : createNewQiException(env, future.error().c_str());
+            env->CallBooleanMethod(completableFuture, method_CompletableFuture_completeExceptionally, error);
+            env->DeleteLocalRef(error);
+        }
+        else
+        {
+            env->CallBooleanMethod(completableFuture, method_CompletableFuture_cancel, JNI_FALSE);
+        }
+
+        if (env->ExceptionCheck() == JNI_TRUE)
+        {
+            qiLogError() << "Exception when completing a CompletableFuture from JNI";
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+        }
+    }
+};
+
 /**
  * @brief The FunctionFunctor struct: P->R
  */
@@ -316,6 +524,55 @@ struct FunctionFunctorUnwrap
         return obtainFutureCfromFutureJava(env, futureAnswer);
     }
 };
+/**
+ * @brief The FunctionChainFunctor struct: P->R through several Java functions called in a row
+ */
+struct FunctionChainFunctor
+{
+    qi::jni::SharedGlobalRef _functions;
+    /**
+     * @brief FunctionChainFunctor::operator () Called by andThenChain
+     * @param res Parent future result
+     * @return Result of the last function
+     */
+    qi::AnyValue operator()(const qi::AnyValue &res) const
+    {
+        // Call Java: Function.execute(P)->R for each function, giving it the previous result
+        jobjectArray functions = static_cast<jobjectArray>(_functions.get());
+
+        qi::jni::JNIAttach attach;
+        JNIEnv *env = attach.get();
+
+        // intermediate results stay local references, only the last one is converted
+        jobject value = extractValue(env, res);
+        const jsize count = env->GetArrayLength(functions);
+
+        for (jsize index = 0; index < count; ++index)
+        {
+            jobject function = env->GetObjectArrayElement(functions, index);
+            jobject answer = nullptr;
+
+            try
+            {
+                answer = callFunctionExecute(env, function, value);
+            }
+            catch (...)
+            {
+                env->DeleteLocalRef(function);
+                env->DeleteLocalRef(value);
+                throw;
+            }
+
+            env->DeleteLocalRef(function);
+            env->DeleteLocalRef(value);
+            value = answer;
+        }
+
+        qi::AnyValue result = qi::AnyValue::from<jobject>(value);
+        env->DeleteLocalRef(value);
+        return result;
+    }
+};
 /**
  * @brief The FutureFunctionFunctor struct: Future<P>->R
  */
@@ -420,18 +677,35 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallCancelRequest(JN
     futureFromPointer(pFuture)->cancel();
 }
 
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallAbandon(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pFuture)
+{
+    abandonCall(*futureFromPointer(pFuture));
+}
+
 JNIEXPORT jobject JNICALL Java_com_aldebaran_qi_Future_qiFutureCallGet(JNIEnv *env, jobject QI_UNUSED(obj), jlong pFuture, jint msecs)
 {
     return obtainValue(env, futureFromPointer(pFuture), msecs);
 }
 
-JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsCancelled(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pFuture)
+JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsCancelled(JNIEnv *QI_UNUSED(env), jclass QI_UNUSED(cls), jlong pFuture)
+{
+    return JavaCritical_com_aldebaran_qi_Future_qiFutureCallIsCancelled(pFuture);
+}
+
+// Critical native entry point, used by HotSpot instead of the one above when the caller is compiled
+JNIEXPORT jboolean JNICALL JavaCritical_com_aldebaran_qi_Future_qiFutureCallIsCancelled(jlong pFuture)
 {
     return futureFromPointer(pFuture)->isCanceled();
 }
 
 //TODO : return a state instead
-JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsDone(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pFuture)
+JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Future_qiFutureCallIsDone(JNIEnv *QI_UNUSED(env), jclass QI_UNUSED(cls), jlong pFuture)
+{
+    return JavaCritical_com_aldebaran_qi_Future_qiFutureCallIsDone(pFuture);
+}
+
+// Critical native entry point, used by HotSpot instead of the one above when the caller is compiled
+JNIEXPORT jboolean JNICALL JavaCritical_com_aldebaran_qi_Future_qiFutureCallIsDone(jlong pFuture)
 {
     return futureFromPointer(pFuture)->isFinished();
 }
@@ -455,10 +729,51 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCallConnectCallback(
     future->connect(CallbackFunctor{ gThisFuture, gCallback }, type);
 }
 
-JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureDestroy(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pFuture)
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureDestroy(JNIEnv* QI_UNUSED(env), jclass QI_UNUSED(cls), jlong pFuture, jint stateSlot)
+{
+    if (stateSlot >= 0)
+    {
+        qi::jni::releaseFutureState(stateSlot);
+    }
+
+    deadlines().remove(futureFromPointer(pFuture));
+    qi::jni::deleteFuture(futureFromPointer(pFuture));
+}
+
+JNIEXPORT jobject JNICALL Java_com_aldebaran_qi_Future_qiFutureStateBuffer(JNIEnv* env, jclass QI_UNUSED(cls))
+{
+    return qi::jni::futureStateBuffer(env);
+}
+
+JNIEXPORT jint JNICALL Java_com_aldebaran_qi_Future_qiFutureStateSlot(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pFuture)
+{
+    return qi::jni::acquireFutureState(*futureFromPointer(pFuture));
+}
+
+/**
+ * Complete a java.util.concurrent.CompletableFuture with the state of the future when it finishes
+ * @param env JNI environment
+ * @param thisFuture Caller object
+ * @param pFuture Future pointer
+ * @param completableFuture CompletableFuture to complete
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureCompleteInto(JNIEnv* env, jobject QI_UNUSED(thisFuture), jlong pFuture, jobject completableFuture)
 {
+    if (!cls_completableFuture)
+    {
+        throwNew(env, "java/lang/UnsupportedOperationException", "CompletableFuture is not available");
+        return;
+    }
+
+    if (!env->IsInstanceOf(completableFuture, cls_completableFuture))
+    {
+        throwNew(env, "java/lang/IllegalArgumentException", "not a CompletableFuture");
+        return;
+    }
+
     auto * future = futureFromPointer(pFuture);
-    delete future;
+    auto gCompletableFuture = qi::jni::makeSharedGlobalRef(env, completableFuture);
+    future->connect(CompletableFutureFunctor{gCompletableFuture, deadlines().find(future)}, qi::FutureCallbackType_Sync);
 }
 
 /**
@@ -467,16 +782,16 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Future_qiFutureDestroy(JNIEnv* QI_U
  * @param thisFuture Caller object
  * @param pFuture Future pointer
  * @param function Function to callback
+ * @param futureCallbackType How to call the function (qi::FutureCallbackType)
  * @return Created future
  */
-JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function)
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function, jint futureCallbackType)
 {
     auto * future = futureFromPointer(pFuture);
     auto gFunction = qi::jni::makeSharedGlobalRef(env, function);
-    qi::Future<qi::AnyValue> result = future->andThen(qi::FutureCallbackType_Async,
+    qi::Future<qi::AnyValue> result = future->andThen(static_cast<qi::FutureCallbackType>(futureCallbackType),
                                                       FunctionFunctor{gFunction});
-    std::unique_ptr<qi::Future<qi::AnyValue>> resultPointer(new auto(result));
-    return reinterpret_cast<jlong>(resultPointer.release());
+    return newFuturePointer(result);
 }
 
 /**
@@ -485,16 +800,16 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThen(JNIEnv* env
  * @param thisFuture Caller object
  * @param pFuture Future pointer
  * @param function Void function to callback
+ * @param futureCallbackType How to call the function (qi::FutureCallbackType)
  * @return Created future
  */
-JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function)
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function, jint futureCallbackType)
 {
     auto * future = futureFromPointer(pFuture);
     auto gFunction = qi::jni::makeSharedGlobalRef(env, function);
-    qi::Future<qi::AnyValue> result = future->andThen(qi::FutureCallbackType_Async,
+    qi::Future<qi::AnyValue> result = future->andThen(static_cast<qi::FutureCallbackType>(futureCallbackType),
                                                       FunctionFunctorVoid{gFunction});
-    std::unique_ptr<qi::Future<qi::AnyValue>> resultPointer(new auto(result));
-    return reinterpret_cast<jlong>(resultPointer.release());
+    return newFuturePointer(result);
 }
 
 /**
@@ -503,17 +818,35 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenVoid(JNIEnv*
  * @param thisFuture Caller object
  * @param pFuture Future pointer
  * @param function Function to callback
+ * @param futureCallbackType How to call the function (qi::FutureCallbackType)
  * @return Created future
  */
-JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function)
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject function, jint futureCallbackType)
 {
     auto * future = futureFromPointer(pFuture);
     auto gFunction = qi::jni::makeSharedGlobalRef(env, function);
-    qi::Future<qi::AnyValue> result = future->andThen(qi::FutureCallbackType_Async,
+    qi::Future<qi::AnyValue> result = future->andThen(static_cast<qi::FutureCallbackType>(futureCallbackType),
                                                       FunctionFunctorUnwrap{gFunction})
                                             .unwrap();
-    std::unique_ptr<qi::Future<qi::AnyValue>> resultPointer(new auto(result));
-    return reinterpret_cast<jlong>(resultPointer.release());
+    return newFuturePointer(result);
+}
+
+/**
+ * Call native future "andThen" once for a chain of Function(P)->R
+ * @param env JNI environment
+ * @param thisFuture Caller object
+ * @param pFuture Future pointer
+ * @param functions Functions to call in a row, each one receiving the result of the previous one
+ * @param futureCallbackType How to call the chain (qi::FutureCallbackType)
+ * @return Created future
+ */
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenChain(JNIEnv* env, jobject QI_UNUSED(thisFuture), jlong pFuture, jobjectArray functions, jint futureCallbackType)
+{
+    auto * future = futureFromPointer(pFuture);
+    auto gFunctions = qi::jni::makeSharedGlobalRef(env, functions);
+    qi::Future<qi::AnyValue> result = future->andThen(static_cast<qi::FutureCallbackType>(futureCallbackType),
+                                                      FunctionChainFunctor{gFunctions});
+    return newFuturePointer(result);
 }
 
 /**
@@ -522,17 +855,17 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureAndThenUnwrap(JNIEn
  * @param thisFuture Caller object
  * @param pFuture Future pointer
  * @param futureFunction Function to callback
+ * @param futureCallbackType How to call the function (qi::FutureCallbackType)
  * @return Created future
  */
-JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction)
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThen(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction, jint futureCallbackType)
 {
     auto * future = futureFromPointer(pFuture);
     auto gThisFuture = qi::jni::makeSharedGlobalRef(env, thisFuture);
     auto gFunction = qi::jni::makeSharedGlobalRef(env, futureFunction);
-    qi::Future<qi::AnyValue> result = future->then(qi::FutureCallbackType_Async,
+    qi::Future<qi::AnyValue> result = future->then(static_cast<qi::FutureCallbackType>(futureCallbackType),
                                                    FutureFunctionFunctor{gThisFuture, gFunction});
-    std::unique_ptr<qi::Future<qi::AnyValue>> resultPointer(new auto(result));
-    return reinterpret_cast<jlong>(resultPointer.release());
+    return newFuturePointer(result);
 }
 
 /**
@@ -541,17 +874,17 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThen(JNIEnv* env, j
  * @param thisFuture Caller object
  * @param pFuture Future pointer
  * @param futureFunction Function to callback
+ * @param futureCallbackType How to call the function (qi::FutureCallbackType)
  * @return Created future
  */
-JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction)
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenVoid(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction, jint futureCallbackType)
 {
     auto * future = futureFromPointer(pFuture);
     auto gThisFuture = qi::jni::makeSharedGlobalRef(env, thisFuture);
     auto gFunction = qi::jni::makeSharedGlobalRef(env, futureFunction);
-    qi::Future<qi::AnyValue> result = future->then(qi::FutureCallbackType_Async,
+    qi::Future<qi::AnyValue> result = future->then(static_cast<qi::FutureCallbackType>(futureCallbackType),
                                                    FutureFunctionFunctorVoid{gThisFuture, gFunction});
-    std::unique_ptr<qi::Future<qi::AnyValue>> resultPointer(new auto(result));
-    return reinterpret_cast<jlong>(resultPointer.release());
+    return newFuturePointer(result);
 }
 
 /**
@@ -560,16 +893,175 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenVoid(JNIEnv* en
  * @param thisFuture Caller object
  * @param pFuture Future pointer
  * @param function Function to callback
+ * @param futureCallbackType How to call the function (qi::FutureCallbackType)
  * @return Created future
  */
-JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction)
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureThenUnwrap(JNIEnv* env, jobject thisFuture, jlong pFuture, jobject futureFunction, jint futureCallbackType)
 {
     auto * future = futureFromPointer(pFuture);
     auto gThisFuture = qi::jni::makeSharedGlobalRef(env, thisFuture);
     auto gFunction = qi::jni::makeSharedGlobalRef(env, futureFunction);
-    qi::Future<qi::AnyValue> result = future->then(qi::FutureCallbackType_Async,
+    qi::Future<qi::AnyValue> result = future->then(static_cast<qi::FutureCallbackType>(futureCallbackType),
                                                    FutureFunctionFunctorUnwrap{gThisFuture, gFunction})
                                             .unwrap();
-    std::unique_ptr<qi::Future<qi::AnyValue>> resultPointer(new auto(result));
-    return reinterpret_cast<jlong>(resultPointer.release());
+    return newFuturePointer(result);
+}
+
+qi::Future<qi::AnyValue> whenAllFutures(const std::vector<qi::Future<qi::AnyValue>> &futures, bool collectValues)
+{
+    if (futures.empty())
+    {
+        return collectValues ? qi::Future<qi::AnyValue>{qi::AnyValue::from(std::vector<qi::AnyValue>{})}
+                             : qi::Future<qi::AnyValue>{qi::AnyValue::from<jobject>(nullptr)};
+    }
+
+    auto state = std::make_shared<WhenAllState>(futures.size(), newCombinedPromise(futures), collectValues);
+
+    for (std::size_t index = 0; index < futures.size(); ++index)
+    {
+        futures[index].connect([state, index](const qi::Future<qi::AnyValue> &future) {
+            if (future.hasValue())
+            {
+                if (!state->values.empty())
+                {
+                    state->values[index] = future.value();
+                }
+
+                if (state->running.fetch_sub(1) == 1 && !state->stopped.exchange(true))
+                {
+                    state->promise.setValue(state->values.empty() ? qi::AnyValue::from<jobject>(nullptr)
+                                                                  : qi::AnyValue::from(state->values));
+                }
+            }
+            else if (!state->stopped.exchange(true))
+            {
+                // the first failing future gives its state
+                if (future.isCanceled())
+                {
+                    state->promise.setCanceled();
+                }
+                else
+                {
+                    state->promise.setError(future.error());
+                }
+            }
+        }, qi::FutureCallbackType_Sync);
+    }
+
+    return state->promise.future();
+}
+
+/**
+ * Create a future finished when all the given futures are finished successfully, or as soon as one of them fails
+ * @param env JNI environment
+ * @param cls Future class
+ * @param pFutures Futures pointers
+ * @param collectValues If true, the created future carries the list of the futures values
+ * @return Created future
+ */
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureWhenAll(JNIEnv* env, jclass QI_UNUSED(cls), jlongArray pFutures, jboolean collectValues)
+{
+    return newFuturePointer(whenAllFutures(futuresFromPointers(env, pFutures), collectValues));
+}
+
+/**
+ * Create a future finished with the state of the first of the given futures to finish
+ * @param env JNI environment
+ * @param cls Future class
+ * @param pFutures Futures pointers
+ * @param keepValue If true, the created future carries the value of the first finished future
+ * @return Created future
+ */
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureWhenAny(JNIEnv* env, jclass QI_UNUSED(cls), jlongArray pFutures, jboolean keepValue)
+{
+    std::vector<qi::Future<qi::AnyValue>> futures = futuresFromPointers(env, pFutures);
+
+    if (futures.empty())
+    {
+        return newFuturePointer(qi::makeFutureError<qi::AnyValue>("no future to wait for"));
+    }
+
+    qi::Promise<qi::AnyValue> promise = newCombinedPromise(futures);
+    auto finished = std::make_shared<std::atomic<bool>>(false);
+    const bool keep = keepValue;
+
+    for (auto &input : futures)
+    {
+        input.connect([promise, finished, keep](const qi::Future<qi::AnyValue> &future) mutable {
+            if (finished->exchange(true))
+            {
+                return;
+            }
+
+            if (future.isCanceled())
+            {
+                promise.setCanceled();
+            }
+            else if (future.hasError())
+            {
+                promise.setError(future.error());
+            }
+            else
+            {
+                promise.setValue(keep ? future.value() : qi::AnyValue::from<jobject>(nullptr));
+            }
+        }, qi::FutureCallbackType_Sync);
+    }
+
+    return newFuturePointer(promise.future());
+}
+
+/**
+ * Create a future that takes the state of the given one, or fails with a timeout
+ * (and cancels the given one) if it is not finished before the given delay
+ * @param env JNI environment
+ * @param thisFuture Caller object
+ * @param pFuture Future pointer
+ * @param msecs Delay in milliseconds
+ * @return Created future
+ */
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Future_qiFutureWithTimeout(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(thisFuture), jlong pFuture, jlong msecs)
+{
+    qi::Future<qi::AnyValue> future = *futureFromPointer(pFuture);
+    qi::Promise<qi::AnyValue> promise = newCombinedPromise({future});
+    auto finished = std::make_shared<std::atomic<bool>>(false);
+    qi::Future<qi::AnyValue>* handle = qi::jni::newFuture(promise.future());
+    DeadlineFlag expired = deadlines().add(handle);
+
+    // the timer runs on the event loop, no thread waits for the deadline
+    qi::Future<void> timer = qi::asyncDelay([future, promise, finished, expired]() mutable {
+        if (finished->exchange(true))
+        {
+            return;
+        }
+
+        // set before the error, so that whoever sees the error sees the flag
+        expired->store(true);
+        future.cancel();
+        promise.setError(futureTimeoutError);
+    }, qi::MilliSeconds(msecs));
+
+    future.connect([promise, finished, timer](const qi::Future<qi::AnyValue> &result) mutable {
+        if (finished->exchange(true))
+        {
+            return;
+        }
+
+        timer.cancel();
+
+        if (result.isCanceled())
+        {
+            promise.setCanceled();
+        }
+        else if (result.hasError())
+        {
+            promise.setError(result.error());
+        }
+        else
+        {
+            promise.setValue(result.value());
+        }
+    }, qi::FutureCallbackType_Sync);
+
+    return reinterpret_cast<jlong>(handle);
 }
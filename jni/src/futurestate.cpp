@@ -0,0 +1,103 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <futurestate.hpp>
+
+namespace qi {
+  namespace jni {
+
+    namespace
+    {
+      const int StateSlots = 65536;
+      const int GenerationShift = 2;
+
+      static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+                    "state words are read by Java as plain integers");
+
+      struct FutureStateTable
+      {
+        FutureStateTable()
+          : words(new std::atomic<std::uint32_t>[StateSlots])
+          , used(0)
+        {
+          for (int slot = 0; slot < StateSlots; ++slot)
+            words[slot].store(0);
+        }
+
+        std::atomic<std::uint32_t>* words;
+        boost::mutex mutex;
+        // slots released by Java, reused first
+        std::vector<int> freeSlots;
+        // slots never used yet are [used, StateSlots)
+        int used;
+      };
+
+      // Never destroyed: Java may read the buffer and finalizers release slots while the library unloads
+      FutureStateTable& table()
+      {
+        static auto* states = new FutureStateTable();
+        return *states;
+      }
+
+      std::uint32_t stateOf(const qi::Future<qi::AnyValue>& future)
+      {
+        if (future.hasValue(0))
+          return FutureStateWord_Value;
+        if (future.hasError(0))
+          return FutureStateWord_Error;
+        return FutureStateWord_Cancelled;
+      }
+    }
+
+    int acquireFutureState(const qi::Future<qi::AnyValue>& future)
+    {
+      FutureStateTable& states = table();
+      int slot;
+      {
+        boost::mutex::scoped_lock lock(states.mutex);
+        if (!states.freeSlots.empty())
+        {
+          slot = states.freeSlots.back();
+          states.freeSlots.pop_back();
+        }
+        else if (states.used < StateSlots)
+          slot = states.used++;
+        else
+          return -1;
+      }
+
+      std::atomic<std::uint32_t>& word = states.words[slot];
+      const std::uint32_t running = ((word.load() >> GenerationShift) + 1) << GenerationShift;
+      word.store(running);
+
+      qi::Future<qi::AnyValue> watched = future;
+      watched.connect([&word, running](const qi::Future<qi::AnyValue>& finished) {
+        // fails if the slot was released and given to another future meanwhile
+        std::uint32_t expected = running;
+        word.compare_exchange_strong(expected, running | stateOf(finished));
+      }, qi::FutureCallbackType_Sync);
+      return slot;
+    }
+
+    void releaseFutureState(int slot)
+    {
+      FutureStateTable& states = table();
+      boost::mutex::scoped_lock lock(states.mutex);
+      states.freeSlots.push_back(slot);
+    }
+
+    jobject futureStateBuffer(JNIEnv* env)
+    {
+      return env->NewDirectByteBuffer(table().words, StateSlots * sizeof(std::uint32_t));
+    }
+  }// !jni
+}// !qi
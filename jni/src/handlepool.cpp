@@ -0,0 +1,45 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <handlepool.hpp>
+
+namespace qi {
+  namespace jni {
+
+    // Pools are never destroyed: Java finalizers may still release handles while the library unloads
+    static HandlePool<qi::Future<qi::AnyValue>>& futurePool()
+    {
+      static auto* pool = new HandlePool<qi::Future<qi::AnyValue>>();
+      return *pool;
+    }
+
+    static HandlePool<qi::Promise<qi::AnyValue>>& promisePool()
+    {
+      static auto* pool = new HandlePool<qi::Promise<qi::AnyValue>>();
+      return *pool;
+    }
+
+    qi::Future<qi::AnyValue>* newFuture(const qi::Future<qi::AnyValue>& future)
+    {
+      return futurePool().create(future);
+    }
+
+    void deleteFuture(qi::Future<qi::AnyValue>* future)
+    {
+      futurePool().destroy(future);
+    }
+
+    qi::Promise<qi::AnyValue>* newPromise(qi::FutureCallbackType type)
+    {
+      return promisePool().create(type);
+    }
+
+    void deletePromise(qi::Promise<qi::AnyValue>* promise)
+    {
+      promisePool().destroy(promise);
+    }
+  }// !jni
+}// !qi
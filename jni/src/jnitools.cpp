@@ -12,6 +12,8 @@
 #include <signal.h>
 #include <qi/signature.hpp>
 #include <qi/session.hpp>
+#include <qi/future.hpp>
+#include <qi/anyvalue.hpp>
 #include "jnitools.hpp"
 
 #include <boost/thread/tss.hpp>
@@ -27,6 +29,7 @@ jclass cls_boolean;
 
 jclass cls_future;
 jfieldID field_future_pointer;
+jfieldID field_future_shared;
 jclass cls_anyobject;
 jclass cls_tuple;
 
@@ -37,9 +40,15 @@ jclass cls_map;
 jclass cls_hashmap;
 
 jclass cls_object;
+jclass cls_objectArray;
 jclass cls_nativeTools;
 jmethodID method_NativeTools_callJava;
 
+jclass cls_completableFuture;
+jmethodID method_CompletableFuture_complete;
+jmethodID method_CompletableFuture_completeExceptionally;
+jmethodID method_CompletableFuture_cancel;
+
 static void emergency()
 {
   qiLogFatal() << "Emergency, aborting";
@@ -74,6 +83,7 @@ static void init_classes(JNIEnv *env)
 
   cls_future = loadClass(env, "com/aldebaran/qi/Future");
   field_future_pointer = env->GetFieldID(cls_future, "_fut", "J");
+  field_future_shared = env->GetFieldID(cls_future, "_shared", "Z");
   cls_anyobject = loadClass(env, "com/aldebaran/qi/AnyObject");
   cls_tuple = loadClass(env, "com/aldebaran/qi/Tuple");
 
@@ -84,17 +94,37 @@ static void init_classes(JNIEnv *env)
   cls_hashmap = loadClass(env, "java/util/HashMap");
 
   cls_object =loadClass(env, "java/lang/Object");
+  cls_objectArray = loadClass(env, "[Ljava/lang/Object;");
   cls_nativeTools = loadClass(env, "com/aldebaran/qi/NativeTools");
 
   method_NativeTools_callJava = env->GetStaticMethodID(cls_nativeTools,
                                                        "callJava",
                                                        "(Ljava/lang/Object;Ljava/lang/String;Ljava/lang/String;[Ljava/lang/Object;)Ljava/lang/Object;");
+
+  jclass completableFuture = env->FindClass("java/util/concurrent/CompletableFuture");
+  if (completableFuture)
+  {
+    cls_completableFuture = reinterpret_cast<jclass>(env->NewGlobalRef(completableFuture));
+    env->DeleteLocalRef(completableFuture);
+    method_CompletableFuture_complete = env->GetMethodID(cls_completableFuture, "complete", "(Ljava/lang/Object;)Z");
+    method_CompletableFuture_completeExceptionally = env->GetMethodID(cls_completableFuture, "completeExceptionally", "(Ljava/lang/Throwable;)Z");
+    method_CompletableFuture_cancel = env->GetMethodID(cls_completableFuture, "cancel", "(Z)Z");
+  }
+  else
+  {
+    // not available on this JVM
+    env->ExceptionClear();
+  }
 }
 
 JNIEXPORT void JNICALL Java_com_aldebaran_qi_EmbeddedTools_initTypeSystem(JNIEnv* env, jclass QI_UNUSED(cls))
 {
   JVM(env);
   init_classes(env);
+  // Not in JNI_OnLoad: finding the classes there would initialize them while the library is still
+  // being loaded, and their static initializers would load it again.
+  // Here, EmbeddedTools has already flagged the library as loaded.
+  qi::jni::registerNatives(env);
 }
 
 /*
@@ -555,15 +585,40 @@ namespace qi {
       env->DeleteLocalRef(obj);
     }
 
+    /**
+     * @brief sharedFuture Get the native future of a com.aldebaran.qi.Future that native code keeps a copy of.
+     * The Java future is flagged as shared, so that collecting it never cancels the operation.
+     * The copy is made holding the monitor of the Java future, so that Future.close() can not
+     * destroy the native one meanwhile.
+     * @param env JNI environment
+     * @param future Java future
+     * @return The native future
+     */
+    qi::Future<qi::AnyValue> sharedFuture(JNIEnv* env, jobject future)
+    {
+      if (env->MonitorEnter(future) != JNI_OK)
+        throw std::runtime_error("Cannot lock the future");
+
+      jlong pointer = env->GetLongField(future, field_future_pointer);
+      if (pointer == 0)
+      {
+        env->MonitorExit(future);
+        throw std::runtime_error("Future already closed");
+      }
+
+      env->SetBooleanField(future, field_future_shared, JNI_TRUE);
+      qi::Future<qi::AnyValue> copy = *reinterpret_cast<qi::Future<qi::AnyValue>*>(pointer);
+      env->MonitorExit(future);
+      return copy;
+    }
+
     jobjectArray toJobjectArray(const std::vector<AnyReference> &values)
     {
       JNIEnv *env = qi::jni::env();
       if (!env)
         return nullptr;
 
-      jclass objectClass = env->FindClass("java/lang/Object");
-      jobjectArray array = env->NewObjectArray(values.size(), objectClass, nullptr);
-      qi::jni::releaseClazz(objectClass);
+      jobjectArray array = env->NewObjectArray(values.size(), cls_object, nullptr);
       int i = 0;
       for (const AnyReference &ref : values)
       {
@@ -332,13 +332,9 @@ qi::AnyReference AnyValue_from_JObject_Tuple(jobject val)
  */
 qi::AnyReference AnyValue_from_JObject_Future(jobject val, JNIEnv* env)
 {
-  auto fieldId = env->GetFieldID(cls_future, "_fut", "J");
-  auto futureAddress = env->GetLongField(val, fieldId);
-  auto future = reinterpret_cast<qi::Future<qi::AnyValue>*>(futureAddress);
-
   // like done with the other types, we store the real data somewhere for the
   // reference to survive
-  auto& futureCopy = *new qi::Future<qi::AnyValue>(*future);
+  auto& futureCopy = *new qi::Future<qi::AnyValue>(qi::jni::sharedFuture(env, val));
   return qi::AnyReference::from(futureCopy);
 }
 
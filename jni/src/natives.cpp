@@ -0,0 +1,112 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <qi/log.hpp>
+
+#include <jnitools.hpp>
+#include <future_jni.hpp>
+#include <promise_jni.hpp>
+#include <session_jni.hpp>
+#include <completionqueue_jni.hpp>
+
+qiLogCategory("qimessaging.java");
+
+#define QI_JNI_NATIVE(name, signature, function) \
+  { const_cast<char*>(name), const_cast<char*>(signature), reinterpret_cast<void*>(&function) }
+
+namespace
+{
+  // Keep in sync with the native methods of com.aldebaran.qi.Future
+  JNINativeMethod futureMethods[] = {
+    QI_JNI_NATIVE("qiFutureCallCancel", "(J)Z", Java_com_aldebaran_qi_Future_qiFutureCallCancel),
+    QI_JNI_NATIVE("qiFutureCallCancelRequest", "(J)V", Java_com_aldebaran_qi_Future_qiFutureCallCancelRequest),
+    QI_JNI_NATIVE("qiFutureCallAbandon", "(J)V", Java_com_aldebaran_qi_Future_qiFutureCallAbandon),
+    QI_JNI_NATIVE("qiFutureCallGet", "(JI)Ljava/lang/Object;", Java_com_aldebaran_qi_Future_qiFutureCallGet),
+    QI_JNI_NATIVE("qiFutureCallIsCancelled", "(J)Z", Java_com_aldebaran_qi_Future_qiFutureCallIsCancelled),
+    QI_JNI_NATIVE("qiFutureCallIsDone", "(J)Z", Java_com_aldebaran_qi_Future_qiFutureCallIsDone),
+    QI_JNI_NATIVE("qiFutureCallWaitWithTimeout", "(JI)V", Java_com_aldebaran_qi_Future_qiFutureCallWaitWithTimeout),
+    QI_JNI_NATIVE("qiFutureDestroy", "(JI)V", Java_com_aldebaran_qi_Future_qiFutureDestroy),
+    QI_JNI_NATIVE("qiFutureStateBuffer", "()Ljava/nio/ByteBuffer;", Java_com_aldebaran_qi_Future_qiFutureStateBuffer),
+    QI_JNI_NATIVE("qiFutureStateSlot", "(J)I", Java_com_aldebaran_qi_Future_qiFutureStateSlot),
+    QI_JNI_NATIVE("qiFutureCompleteInto", "(JLjava/lang/Object;)V", Java_com_aldebaran_qi_Future_qiFutureCompleteInto),
+    QI_JNI_NATIVE("qiFutureCallConnectCallback", "(JLcom/aldebaran/qi/Future$Callback;I)V", Java_com_aldebaran_qi_Future_qiFutureCallConnectCallback),
+    QI_JNI_NATIVE("qiFutureAndThen", "(JLcom/aldebaran/qi/Function;I)J", Java_com_aldebaran_qi_Future_qiFutureAndThen),
+    QI_JNI_NATIVE("qiFutureAndThenVoid", "(JLcom/aldebaran/qi/Consumer;I)J", Java_com_aldebaran_qi_Future_qiFutureAndThenVoid),
+    QI_JNI_NATIVE("qiFutureAndThenUnwrap", "(JLcom/aldebaran/qi/Function;I)J", Java_com_aldebaran_qi_Future_qiFutureAndThenUnwrap),
+    QI_JNI_NATIVE("qiFutureAndThenChain", "(J[Ljava/lang/Object;I)J", Java_com_aldebaran_qi_Future_qiFutureAndThenChain),
+    QI_JNI_NATIVE("qiFutureThen", "(JLcom/aldebaran/qi/Function;I)J", Java_com_aldebaran_qi_Future_qiFutureThen),
+    QI_JNI_NATIVE("qiFutureThenVoid", "(JLcom/aldebaran/qi/Consumer;I)J", Java_com_aldebaran_qi_Future_qiFutureThenVoid),
+    QI_JNI_NATIVE("qiFutureThenUnwrap", "(JLcom/aldebaran/qi/Function;I)J", Java_com_aldebaran_qi_Future_qiFutureThenUnwrap),
+    QI_JNI_NATIVE("qiFutureWhenAll", "([JZ)J", Java_com_aldebaran_qi_Future_qiFutureWhenAll),
+    QI_JNI_NATIVE("qiFutureWhenAny", "([JZ)J", Java_com_aldebaran_qi_Future_qiFutureWhenAny),
+    QI_JNI_NATIVE("qiFutureWithTimeout", "(JJ)J", Java_com_aldebaran_qi_Future_qiFutureWithTimeout),
+  };
+
+  // Keep in sync with the native methods of com.aldebaran.qi.Promise
+  JNINativeMethod promiseMethods[] = {
+    QI_JNI_NATIVE("_newPromise", "(I)J", Java_com_aldebaran_qi_Promise__1newPromise),
+    QI_JNI_NATIVE("_getFuture", "(J)J", Java_com_aldebaran_qi_Promise__1getFuture),
+    QI_JNI_NATIVE("_setValue", "(JLjava/lang/Object;)V", Java_com_aldebaran_qi_Promise__1setValue),
+    QI_JNI_NATIVE("_setInt", "(JI)V", Java_com_aldebaran_qi_Promise__1setInt),
+    QI_JNI_NATIVE("_setLong", "(JJ)V", Java_com_aldebaran_qi_Promise__1setLong),
+    QI_JNI_NATIVE("_setDouble", "(JD)V", Java_com_aldebaran_qi_Promise__1setDouble),
+    QI_JNI_NATIVE("_setString", "(JLjava/lang/String;)V", Java_com_aldebaran_qi_Promise__1setString),
+    QI_JNI_NATIVE("_setBytes", "(J[B)V", Java_com_aldebaran_qi_Promise__1setBytes),
+    QI_JNI_NATIVE("_setVoid", "(J)V", Java_com_aldebaran_qi_Promise__1setVoid),
+    QI_JNI_NATIVE("_setValues", "([J[Ljava/lang/Object;)V", Java_com_aldebaran_qi_Promise__1setValues),
+    QI_JNI_NATIVE("_setError", "(JLjava/lang/String;)V", Java_com_aldebaran_qi_Promise__1setError),
+    QI_JNI_NATIVE("_setCancelled", "(J)V", Java_com_aldebaran_qi_Promise__1setCancelled),
+    QI_JNI_NATIVE("_setOnCancel", "(JLcom/aldebaran/qi/Promise$CancelRequestCallback;)V", Java_com_aldebaran_qi_Promise__1setOnCancel),
+    QI_JNI_NATIVE("_destroyPromise", "(J)V", Java_com_aldebaran_qi_Promise__1destroyPromise),
+  };
+
+  // Keep in sync with the native methods of com.aldebaran.qi.CompletionQueue
+  JNINativeMethod completionQueueMethods[] = {
+    QI_JNI_NATIVE("qiCompletionQueueCreate", "()J", Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueCreate),
+    QI_JNI_NATIVE("qiCompletionQueueRegister", "(JLcom/aldebaran/qi/Future;J)V", Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueRegister),
+    QI_JNI_NATIVE("qiCompletionQueueDrain", "(J[J[I[Ljava/lang/Object;J)I", Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueDrain),
+    QI_JNI_NATIVE("qiCompletionQueueClose", "(J)V", Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueClose),
+    QI_JNI_NATIVE("qiCompletionQueueDestroy", "(J)V", Java_com_aldebaran_qi_CompletionQueue_qiCompletionQueueDestroy),
+  };
+
+  // Only the trivial ones: the others are still found by name
+  JNINativeMethod sessionMethods[] = {
+    QI_JNI_NATIVE("qiSessionDestroy", "(J)V", Java_com_aldebaran_qi_Session_qiSessionDestroy),
+    QI_JNI_NATIVE("qiSessionIsConnected", "(J)Z", Java_com_aldebaran_qi_Session_qiSessionIsConnected),
+  };
+
+  template <std::size_t N>
+  void registerClassNatives(JNIEnv* env, const char* className, JNINativeMethod (&methods)[N])
+  {
+    jclass cls = env->FindClass(className);
+    if (!cls || env->RegisterNatives(cls, methods, static_cast<jint>(N)) != JNI_OK)
+    {
+      // the exported Java_* symbols are still found by name
+      if (env->ExceptionCheck())
+      {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+      }
+      qiLogWarning() << "Cannot register the native methods of " << className;
+    }
+
+    if (cls)
+      env->DeleteLocalRef(cls);
+  }
+}
+
+namespace qi {
+  namespace jni {
+
+    void registerNatives(JNIEnv* env)
+    {
+      registerClassNatives(env, "com/aldebaran/qi/Future", futureMethods);
+      registerClassNatives(env, "com/aldebaran/qi/Promise", promiseMethods);
+      registerClassNatives(env, "com/aldebaran/qi/CompletionQueue", completionQueueMethods);
+      registerClassNatives(env, "com/aldebaran/qi/Session", sessionMethods);
+    }
+  }// !jni
+}// !qi
@@ -11,34 +11,106 @@
 #include <qi/jsoncodec.hpp>
 
 #include <jnitools.hpp>
+#include <handlepool.hpp>
 #include <object.hpp>
 #include <callbridge.hpp>
 #include <jobjectconverter.hpp>
+#include <future_jni.hpp>
+#include <signalqueue.hpp>
 
 qiLogCategory("qimessaging.jni");
 
 extern MethodInfoHandler gInfoHandler;
 
+namespace
+{
+  // JNI limits a method to 255 parameters, the primitive listeners to this
+  const std::size_t MaxPrimitiveArgs = 32;
+
+  /**
+   * @brief primitiveDescriptor Descriptor of the Java primitive type receiving a qi type
+   * @return 0 if the type is not a primitive one
+   */
+  char primitiveDescriptor(char qiType)
+  {
+    switch (qiType)
+    {
+    case qi::Signature::Type_Bool:
+      return 'Z';
+    case qi::Signature::Type_Int8:
+    case qi::Signature::Type_UInt8:
+      return 'B';
+    case qi::Signature::Type_Int16:
+    case qi::Signature::Type_UInt16:
+      return 'S';
+    case qi::Signature::Type_Int32:
+    case qi::Signature::Type_UInt32:
+      return 'I';
+    case qi::Signature::Type_Int64:
+    case qi::Signature::Type_UInt64:
+      return 'J';
+    case qi::Signature::Type_Float:
+      return 'F';
+    case qi::Signature::Type_Double:
+      return 'D';
+    default:
+      return 0;
+    }
+  }
+
+  jvalue toJvalue(const qi::AnyReference &arg, char qiType)
+  {
+    jvalue value;
+    switch (qiType)
+    {
+    case qi::Signature::Type_Bool:
+      value.z = arg.to<bool>() ? JNI_TRUE : JNI_FALSE;
+      break;
+    case qi::Signature::Type_Int8:
+    case qi::Signature::Type_UInt8:
+      value.b = static_cast<jbyte>(arg.toInt());
+      break;
+    case qi::Signature::Type_Int16:
+    case qi::Signature::Type_UInt16:
+      value.s = static_cast<jshort>(arg.toInt());
+      break;
+    case qi::Signature::Type_Int32:
+    case qi::Signature::Type_UInt32:
+      value.i = static_cast<jint>(arg.toInt());
+      break;
+    case qi::Signature::Type_Int64:
+      value.j = static_cast<jlong>(arg.toInt());
+      break;
+    case qi::Signature::Type_UInt64:
+      // same bits, as Java has no unsigned types
+      value.j = static_cast<jlong>(arg.toUInt());
+      break;
+    case qi::Signature::Type_Float:
+      value.f = arg.toFloat();
+      break;
+    default:
+      value.d = arg.toDouble();
+      break;
+    }
+    return value;
+  }
+}
+
 JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_property(JNIEnv* env, jobject QI_UNUSED(jobj), jlong pObj, jstring name)
 {
   qi::AnyObject&     obj = *(reinterpret_cast<qi::AnyObject*>(pObj));
   std::string        propName = qi::jni::toString(name);
 
-  qi::Future<qi::AnyValue>* ret = new qi::Future<qi::AnyValue>();
-
   qi::jni::JNIAttach attach(env);
 
   try
   {
-    *ret = obj.property<qi::AnyValue>(propName);
+    return (jlong) qi::jni::newFuture(obj.property<qi::AnyValue>(propName));
   } catch (qi::FutureUserException& e)
   {
-    delete ret;
     throwNewDynamicCallException(env, e.what());
     return 0;
   }
-
-  return (jlong) ret;
 }
 
 JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_setProperty(
@@ -50,9 +122,63 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_setProperty(
   qi::jni::JNIAttach attach(env);
   try
   {
-    std::unique_ptr<qi::Future<qi::AnyValue>> futurePtr{new qi::Future<qi::AnyValue>()};
-    *futurePtr = qi::toAnyValueFuture(objectPtr->setProperty(propertyName, qi::AnyValue::from<jobject>(jValue)).async());
-    return reinterpret_cast<jlong>(futurePtr.release());
+    auto futurePtr = qi::jni::newFuture(qi::toAnyValueFuture(objectPtr->setProperty(propertyName, qi::AnyValue::from<jobject>(jValue)).async()));
+    return reinterpret_cast<jlong>(futurePtr);
+  }
+  catch (std::runtime_error &e)
+  {
+    throwNewDynamicCallException(env, e.what());
+    return 0;
+  }
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_properties(JNIEnv* env, jobject QI_UNUSED(jobj), jlong pObj, jobjectArray names)
+{
+  qi::AnyObject&     obj = *(reinterpret_cast<qi::AnyObject*>(pObj));
+  const jsize        count = env->GetArrayLength(names);
+  std::vector<qi::Future<qi::AnyValue>> futures;
+
+  qi::jni::JNIAttach attach(env);
+
+  try
+  {
+    // all the reads are sent before any reply is awaited
+    futures.reserve(count);
+    for (jsize i = 0; i < count; ++i)
+    {
+      jstring name = reinterpret_cast<jstring>(env->GetObjectArrayElement(names, i));
+      futures.push_back(obj.property<qi::AnyValue>(qi::jni::toString(name)));
+      env->DeleteLocalRef(name);
+    }
+    return (jlong) qi::jni::newFuture(whenAllFutures(futures, true));
+  } catch (std::exception& e)
+  {
+    throwNewDynamicCallException(env, e.what());
+    return 0;
+  }
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_setProperties(
+    JNIEnv* env, jobject /*jObject*/, jlong objectAddress, jobjectArray jPropertyNames, jobjectArray jValues)
+{
+  auto objectPtr = reinterpret_cast<qi::AnyObject*>(objectAddress);
+  const jsize count = env->GetArrayLength(jPropertyNames);
+  std::vector<qi::Future<qi::AnyValue>> futures;
+
+  qi::jni::JNIAttach attach(env);
+  try
+  {
+    futures.reserve(count);
+    for (jsize i = 0; i < count; ++i)
+    {
+      jstring jPropertyName = reinterpret_cast<jstring>(env->GetObjectArrayElement(jPropertyNames, i));
+      jobject jValue = env->GetObjectArrayElement(jValues, i);
+      auto propertyName = qi::jni::toString(jPropertyName);
+      futures.push_back(qi::toAnyValueFuture(objectPtr->setProperty(propertyName, qi::AnyValue::from<jobject>(jValue)).async()));
+      env->DeleteLocalRef(jValue);
+      env->DeleteLocalRef(jPropertyName);
+    }
+    return reinterpret_cast<jlong>(qi::jni::newFuture(whenAllFutures(futures, false)));
   }
   catch (std::runtime_error &e)
   {
@@ -184,7 +310,101 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connectSignal(JNIEnv *en
   qi::Future<qi::SignalLink> signalLinkFuture = anyObject->connect(signalName, subscriber);
 
   qi::Future<qi::AnyValue> future = qi::toAnyValueFuture(std::move(signalLinkFuture));
-  auto futurePtr = new qi::Future<qi::AnyValue>(std::move(future));
+  auto futurePtr = qi::jni::newFuture(future);
+  return reinterpret_cast<jlong>(futurePtr);
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connectSignalPrimitive(JNIEnv *env, jobject QI_UNUSED(obj), jlong pObject, jstring jSignalName, jobject listener, jobject method, jstring jParameterDescriptors)
+{
+  qi::AnyObject *anyObject = reinterpret_cast<qi::AnyObject *>(pObject);
+  std::string signalName = qi::jni::toString(jSignalName);
+  std::string parameterDescriptors = qi::jni::toString(jParameterDescriptors);
+
+  // check the slot against the signal once, instead of converting each emission
+  const qi::MetaObject &metaObject = anyObject->metaObject();
+  int signalId = metaObject.signalId(signalName);
+  const qi::MetaSignal *metaSignal = signalId < 0 ? nullptr : metaObject.signal(signalId);
+  if (!metaSignal)
+  {
+    throwNew(env, "com/aldebaran/qi/QiSlotException", ("Signal \"" + signalName + "\" not found").c_str());
+    return 0;
+  }
+
+  std::string qiTypes;
+  for (const qi::Signature &parameter : metaSignal->parametersSignature().children())
+    qiTypes += static_cast<char>(parameter.type());
+
+  bool matches = qiTypes.size() == parameterDescriptors.size() && qiTypes.size() <= MaxPrimitiveArgs;
+  for (std::size_t i = 0; matches && i < qiTypes.size(); ++i)
+    matches = primitiveDescriptor(qiTypes[i]) == parameterDescriptors[i];
+  if (!matches)
+  {
+    std::string message = "Slot parameters (" + parameterDescriptors + ") do not match signal "
+        + signalName + metaSignal->parametersSignature().toString();
+    throwNew(env, "com/aldebaran/qi/QiSlotException", message.c_str());
+    return 0;
+  }
+
+  auto gListener = qi::jni::makeSharedGlobalRef(env, listener);
+  jmethodID methodId = env->FromReflectedMethod(method);
+
+  qi::SignalSubscriber subscriber {
+    qi::AnyFunction::fromDynamicFunction(
+      [gListener, methodId, qiTypes](const std::vector<qi::AnyReference> &params) -> qi::AnyReference {
+        jvalue values[MaxPrimitiveArgs];
+        try
+        {
+          for (std::size_t i = 0; i < qiTypes.size(); ++i)
+            values[i] = toJvalue(params.at(i), qiTypes[i]);
+        }
+        catch (const std::exception &e)
+        {
+          qiLogWarning() << "Cannot convert signal arguments: " << e.what();
+          return {};
+        }
+
+        qi::jni::JNIAttach attach;
+        JNIEnv *env = attach.get();
+
+        env->CallVoidMethodA(gListener.get(), methodId, values);
+        if (env->ExceptionCheck())
+        {
+          env->ExceptionDescribe();
+          // an exception occurred in a listener, report and ignore
+          env->ExceptionClear();
+        }
+        return {}; // a void AnyReference
+      }
+    )
+  };
+
+  qi::Future<qi::SignalLink> signalLinkFuture = anyObject->connect(signalName, subscriber);
+
+  qi::Future<qi::AnyValue> future = qi::toAnyValueFuture(std::move(signalLinkFuture));
+  auto futurePtr = qi::jni::newFuture(future);
+  return reinterpret_cast<jlong>(futurePtr);
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_connectSignalQueue(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pObject, jstring jSignalName, jlong pQueue)
+{
+  qi::AnyObject *anyObject = reinterpret_cast<qi::AnyObject *>(pObject);
+  std::string signalName = qi::jni::toString(jSignalName);
+  qi::jni::SignalQueuePtr queue = qi::jni::signalQueueFromPointer(pQueue);
+
+  qi::SignalSubscriber subscriber {
+    qi::AnyFunction::fromDynamicFunction(
+      [queue](const std::vector<qi::AnyReference> &params) -> qi::AnyReference {
+        // no JNI here, the emission is delivered later by the queue
+        queue->push(params);
+        return {}; // a void AnyReference
+      }
+    )
+  };
+
+  qi::Future<qi::SignalLink> signalLinkFuture = anyObject->connect(signalName, subscriber);
+
+  qi::Future<qi::AnyValue> future = qi::toAnyValueFuture(std::move(signalLinkFuture));
+  auto futurePtr = qi::jni::newFuture(future);
   return reinterpret_cast<jlong>(futurePtr);
 }
 
@@ -194,7 +414,7 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_AnyObject_disconnectSignal(JNIEnv
   qi::Future<void> disconnectFuture = anyObject->disconnect(subscriberId);
 
   qi::Future<qi::AnyValue> future = qi::toAnyValueFuture(std::move(disconnectFuture));
-  auto futurePtr = new qi::Future<qi::AnyValue>(std::move(future));
+  auto futurePtr = qi::jni::newFuture(future);
   return reinterpret_cast<jlong>(futurePtr);
 }
 
@@ -44,7 +44,17 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_destroy(JNIEnv
   delete ob;
 }
 
-JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_advertiseMethod(JNIEnv *env, jobject jobj, jlong pObjectBuilder, jstring method, jobject instance, jstring className, jstring desc)
+/**
+ * @brief advertiseMethod Bind a Java method on the generic Java callback
+ * @param env JNI environment
+ * @param jobj DynamicObjectBuilder Java instance
+ * @param pObjectBuilder Pointer on the native builder
+ * @param method libqi signature of the method
+ * @param instance Java instance implementing the method
+ * @param desc Method description
+ * @param async If true, the Java method returns a com.aldebaran.qi.Future which is forwarded as is to libqi
+ */
+static void advertiseMethod(JNIEnv *env, jobject jobj, jlong pObjectBuilder, jstring method, jobject instance, jstring desc, bool async)
 {
   extern MethodInfoHandler   gInfoHandler;
   qi::DynamicObjectBuilder  *ob = reinterpret_cast<qi::DynamicObjectBuilder *>(pObjectBuilder);
@@ -73,7 +83,7 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_advertiseMetho
     ob->xAdvertiseMethod(sigInfo[0],
         sigInfo[1],
         sigInfo[2],
-        qi::AnyFunction::fromDynamicFunction(boost::bind(&call_to_java, signature, data, _1)).dropFirstArgument(),
+        qi::AnyFunction::fromDynamicFunction(boost::bind(async ? &call_to_java_async : &call_to_java, signature, data, _1)).dropFirstArgument(),
         description);
   }
   catch (std::runtime_error &e)
@@ -82,6 +92,16 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_advertiseMetho
   }
 }
 
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_advertiseMethod(JNIEnv *env, jobject jobj, jlong pObjectBuilder, jstring method, jobject instance, jstring QI_UNUSED(className), jstring desc)
+{
+  advertiseMethod(env, jobj, pObjectBuilder, method, instance, desc, false);
+}
+
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_advertiseAsyncMethod(JNIEnv *env, jobject jobj, jlong pObjectBuilder, jstring method, jobject instance, jstring QI_UNUSED(className), jstring desc)
+{
+  advertiseMethod(env, jobj, pObjectBuilder, method, instance, desc, true);
+}
+
 JNIEXPORT void JNICALL Java_com_aldebaran_qi_DynamicObjectBuilder_advertiseSignal(JNIEnv *env, jobject QI_UNUSED(obj), jlong pObjectBuilder, jstring eventSignature)
 {
   qi::DynamicObjectBuilder  *ob = reinterpret_cast<qi::DynamicObjectBuilder *>(pObjectBuilder);
@@ -1,7 +1,11 @@
 #include "promise_jni.hpp"
 
+#include <vector>
+
+#include <qi/buffer.hpp>
 #include <qi/future.hpp>
 #include "jnitools.hpp"
+#include "handlepool.hpp"
 
 qiLogCategory("qimessaging.java");
 
@@ -14,7 +18,7 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Promise__1newPromise
   (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jint futureCallbackType)
 {
   qi::FutureCallbackType type = static_cast<qi::FutureCallbackType>(futureCallbackType);
-  auto promisePtr = new qi::Promise<qi::AnyValue>(type);
+  auto promisePtr = qi::jni::newPromise(type);
   return reinterpret_cast<jlong>(promisePtr);
 }
 
@@ -27,7 +31,7 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Promise__1getFuture
   (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong promisePtr)
 {
   auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
-  auto futurePtr = new qi::Future<qi::AnyValue>{ promise->future() };
+  auto futurePtr = qi::jni::newFuture(promise->future());
   return reinterpret_cast<jlong>(futurePtr);
 }
 
@@ -43,6 +47,106 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setValue
   promise->setValue(qi::AnyValue::from<jobject>(value));
 }
 
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setInt
+ * Signature: (JI)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setInt
+  (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong promisePtr, jint value)
+{
+  auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
+  promise->setValue(qi::AnyValue::from(static_cast<int>(value)));
+}
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setLong
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setLong
+  (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong promisePtr, jlong value)
+{
+  auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
+  promise->setValue(qi::AnyValue::from(static_cast<qi::int64_t>(value)));
+}
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setDouble
+ * Signature: (JD)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setDouble
+  (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong promisePtr, jdouble value)
+{
+  auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
+  promise->setValue(qi::AnyValue::from(static_cast<double>(value)));
+}
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setString
+ * Signature: (JLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setString
+  (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong promisePtr, jstring value)
+{
+  auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
+  promise->setValue(qi::AnyValue::from(qi::jni::toString(value)));
+}
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setBytes
+ * Signature: (J[B)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setBytes
+  (JNIEnv *env, jobject QI_UNUSED(obj), jlong promisePtr, jbyteArray value)
+{
+  auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
+  const jsize size = env->GetArrayLength(value);
+  qi::Buffer buffer;
+
+  jbyte *data = env->GetByteArrayElements(value, nullptr);
+  buffer.write(data, static_cast<size_t>(size));
+  env->ReleaseByteArrayElements(value, data, JNI_ABORT);
+
+  promise->setValue(qi::AnyValue::from(buffer));
+}
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setVoid
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setVoid
+  (JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong promisePtr)
+{
+  auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
+  promise->setValue(qi::AnyValue(qi::typeOf<void>()));
+}
+
+/*
+ * Class:     com_aldebaran_qi_Promise
+ * Method:    _setValues
+ * Signature: ([J[Ljava/lang/Object;)V
+ */
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setValues
+  (JNIEnv *env, jclass QI_UNUSED(cls), jlongArray promisePtrs, jobjectArray values)
+{
+  const jsize size = env->GetArrayLength(promisePtrs);
+  std::vector<jlong> pointers(size);
+  env->GetLongArrayRegion(promisePtrs, 0, size, pointers.data());
+
+  for (jsize i = 0; i < size; ++i)
+  {
+    auto promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(pointers[i]);
+    jobject value = env->GetObjectArrayElement(values, i);
+    promise->setValue(qi::AnyValue::from<jobject>(value));
+    env->DeleteLocalRef(value);
+  }
+}
+
 /*
  * Class:     com_aldebaran_qi_Promise
  * Method:    _setError
@@ -100,12 +204,12 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1setOnCancel(JNIEnv *env,
 /**
  * @brief Java_com_aldebaran_qi_Promise__1destroyPromise : Destroy the promise from memory
  * @param env         Work environment
- * @param thisPromise Promise object
+ * @param cls         Promise class
  * @param promisePtr  Pointer on promise
  */
-JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1destroyPromise(JNIEnv *env, jobject thisPromise, jlong promisePtr)
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Promise__1destroyPromise(JNIEnv *QI_UNUSED(env), jclass QI_UNUSED(cls), jlong promisePtr)
 {
   qi::Promise<qi::AnyValue> * promise = reinterpret_cast<qi::Promise<qi::AnyValue> *>(promisePtr);
-  delete promise;
+  qi::jni::deletePromise(promise);
 }
 
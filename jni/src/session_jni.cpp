@@ -7,15 +7,21 @@
 ** See COPYING for the license
 */
 
+#include <memory>
 #include <stdexcept>
 
+#include <boost/thread/mutex.hpp>
+
 #include <qi/log.hpp>
 #include <qi/api.hpp>
 #include <qi/anyfunction.hpp>
+#include <qi/clock.hpp>
+#include <qi/eventloop.hpp>
 #include <qi/session.hpp>
 
 #include <jni.h>
 #include <jnitools.hpp>
+#include <handlepool.hpp>
 #include <session_jni.hpp>
 #include <object_jni.hpp>
 #include <callbridge.hpp>
@@ -32,13 +38,19 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Session_qiSessionCreate(JNIEnv *QI
   return (jlong) session;
 }
 
-JNIEXPORT void JNICALL Java_com_aldebaran_qi_Session_qiSessionDestroy(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pSession)
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Session_qiSessionDestroy(JNIEnv *QI_UNUSED(env), jclass QI_UNUSED(cls), jlong pSession)
 {
   qi::Session *s = reinterpret_cast<qi::Session*>(pSession);
   delete s;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Session_qiSessionIsConnected(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pSession)
+JNIEXPORT jboolean JNICALL Java_com_aldebaran_qi_Session_qiSessionIsConnected(JNIEnv *QI_UNUSED(env), jclass QI_UNUSED(cls), jlong pSession)
+{
+  return JavaCritical_com_aldebaran_qi_Session_qiSessionIsConnected(pSession);
+}
+
+// Critical native entry point, used by HotSpot instead of the one above when the caller is compiled
+JNIEXPORT jboolean JNICALL JavaCritical_com_aldebaran_qi_Session_qiSessionIsConnected(jlong pSession)
 {
   qi::Session *s = reinterpret_cast<qi::Session*>(pSession);
 
@@ -64,9 +76,8 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Session_qiSessionConnect(JNIEnv *e
   // After this function return, callbacks are going to be set on new created Future.
   // Save the JVM pointer here to avoid big issues when callbacks will be called.
   JVM(env);
-  qi::Future<qi::AnyValue> *fref = new qi::Future<qi::AnyValue>();
   qi::Promise<qi::AnyValue> promise;
-  *fref = promise.future();
+  qi::Future<qi::AnyValue> *fref = qi::jni::newFuture(promise.future());
   qi::Session *s = reinterpret_cast<qi::Session*>(pSession);
   try
   {
@@ -80,6 +91,177 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Session_qiSessionConnect(JNIEnv *e
   return (jlong) fref;
 }
 
+namespace
+{
+  using ProbePtr = std::unique_ptr<qi::Session>;
+
+  /**
+   * @brief The EndpointRace struct: shared by the connection attempts of qiSessionConnectRace
+   */
+  struct EndpointRace
+  {
+    explicit EndpointRace(std::size_t count)
+      : count(count)
+      , failed(0)
+      , finished(false)
+    {
+    }
+
+    const std::size_t count;
+    boost::mutex mutex;
+    std::size_t failed;
+    bool finished;
+    std::string errors;
+    // cleared once finished, they refer to the race
+    std::vector<qi::Future<void>> timers;
+    std::vector<ProbePtr> probes;
+    qi::Promise<qi::AnyValue> promise;
+  };
+  using EndpointRacePtr = std::shared_ptr<EndpointRace>;
+
+  // Must be called with the race locked, the returned probes are to be discarded once unlocked
+  std::vector<ProbePtr> finishRace(EndpointRace &race)
+  {
+    race.finished = true;
+    for (qi::Future<void> &timer : race.timers)
+      timer.cancel();
+    race.timers.clear();
+    std::vector<ProbePtr> probes;
+    probes.swap(race.probes);
+    return probes;
+  }
+
+  void discardProbe(ProbePtr probe)
+  {
+    // not from the callback of a connection attempt, which may be its own
+    std::shared_ptr<qi::Session> discarded(probe.release());
+    qi::async([discarded] {
+      discarded->close();
+    });
+  }
+
+  void onAttemptFinished(EndpointRacePtr race, qi::Session *attemptProbe, const std::string &url,
+                         qi::SteadyClock::time_point start, qi::Future<void> attempt)
+  {
+    const qi::int64_t handshakeMicros = boost::chrono::duration_cast<qi::MicroSeconds>(qi::SteadyClock::now() - start).count();
+    const bool succeeded = !attempt.hasError() && !attempt.isCanceled();
+    std::vector<ProbePtr> probes;
+    {
+      boost::mutex::scoped_lock lock(race->mutex);
+      if (race->finished)
+        return;
+
+      if (!succeeded)
+      {
+        race->errors += "\n  " + url + ": " + (attempt.hasError() ? attempt.error() : "cancelled");
+        if (++race->failed < race->count)
+          return;
+      }
+      probes = finishRace(*race);
+    }
+
+    // the winning probe becomes the session, the other attempts are useless now
+    qi::Session *winner = nullptr;
+    for (ProbePtr &probe : probes)
+    {
+      if (succeeded && probe.get() == attemptProbe)
+        winner = probe.release();
+      else
+        discardProbe(std::move(probe));
+    }
+
+    if (!winner)
+    {
+      race->promise.setError("Cannot connect to any endpoint:" + race->errors);
+      return;
+    }
+
+    race->promise.setValue(qi::AnyValue::from(std::vector<qi::AnyValue>{
+        qi::AnyValue::from(url),
+        qi::AnyValue::from(handshakeMicros),
+        qi::AnyValue::from(static_cast<qi::int64_t>(reinterpret_cast<jlong>(winner)))}));
+  }
+
+  void startAttempt(EndpointRacePtr race, const std::string &url)
+  {
+    ProbePtr probe(new qi::Session());
+    qi::Session *attemptProbe = probe.get();
+    const qi::SteadyClock::time_point start = qi::SteadyClock::now();
+    qi::Future<void> attempt;
+    {
+      // the probe is owned by the race, which may discard it as soon as it is unlocked
+      boost::mutex::scoped_lock lock(race->mutex);
+      if (race->finished)
+        return;
+      try
+      {
+        attempt = attemptProbe->connect(url);
+      }
+      catch (const std::exception& e)
+      {
+        attempt = qi::makeFutureError<void>(e.what());
+      }
+      race->probes.push_back(std::move(probe));
+    }
+
+    attempt.connect([race, attemptProbe, url, start](qi::Future<void> finished) {
+      onAttemptFinished(race, attemptProbe, url, start, finished);
+    });
+  }
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Session_qiSessionConnectRace(JNIEnv *env, jclass QI_UNUSED(cls), jobjectArray jurls, jlong staggerMicros)
+{
+  JVM(env);
+  std::vector<std::string> urls;
+  const jsize count = env->GetArrayLength(jurls);
+  for (jsize i = 0; i < count; ++i)
+  {
+    jstring url = reinterpret_cast<jstring>(env->GetObjectArrayElement(jurls, i));
+    urls.push_back(qi::jni::toString(url));
+    env->DeleteLocalRef(url);
+  }
+
+  auto race = std::make_shared<EndpointRace>(urls.size());
+  // weak: the race owns the promise
+  std::weak_ptr<EndpointRace> weakRace = race;
+  race->promise.setOnCancel([weakRace](qi::Promise<qi::AnyValue> promise) {
+    auto race = weakRace.lock();
+    if (!race)
+      return;
+
+    std::vector<ProbePtr> probes;
+    {
+      boost::mutex::scoped_lock lock(race->mutex);
+      if (race->finished)
+        return;
+      probes = finishRace(*race);
+    }
+
+    for (ProbePtr &probe : probes)
+      discardProbe(std::move(probe));
+    promise.setCanceled();
+  });
+  qi::Future<qi::AnyValue> *fref = qi::jni::newFuture(race->promise.future());
+  if (urls.empty())
+  {
+    race->promise.setError("No endpoint to connect to");
+    return (jlong) fref;
+  }
+
+  // a session connects only once: each endpoint is tried by a session of its own, the winner is adopted
+  startAttempt(race, urls[0]);
+  boost::mutex::scoped_lock lock(race->mutex);
+  for (std::size_t i = 1; i < urls.size() && !race->finished; ++i)
+  {
+    const std::string url = urls[i];
+    race->timers.push_back(qi::asyncDelay([race, url] {
+      startAttempt(race, url);
+    }, qi::MicroSeconds(staggerMicros * i)));
+  }
+  return (jlong) fref;
+}
+
 JNIEXPORT void JNICALL Java_com_aldebaran_qi_Session_qiSessionClose(JNIEnv *QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pSession)
 {
   qi::Session *s = reinterpret_cast<qi::Session*>(pSession);
@@ -97,7 +279,7 @@ JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_Session_service(JNIEnv *env, jobje
     qi::Future<qi::AnyObject> serviceFuture = s->service(serviceName);
     // qiFutureCallGet() requires that the future returns a qi::AnyValue
     qi::Future<qi::AnyValue> future = qi::toAnyValueFuture(std::move(serviceFuture));
-    auto futurePtr = new qi::Future<qi::AnyValue>(std::move(future));
+    auto futurePtr = qi::jni::newFuture(future);
     return reinterpret_cast<jlong>(futurePtr);
   }
   catch (std::runtime_error &e)
@@ -182,6 +364,19 @@ JNIEXPORT void JNICALL Java_com_aldebaran_qi_Session_addConnectionListener(JNIEn
   });
 }
 
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_Session_addServiceListener(JNIEnv *env, jobject QI_UNUSED(obj), jlong pSession, jobject listener)
+{
+  qi::Session *session = reinterpret_cast<qi::Session*>(pSession);
+  auto gListener = qi::jni::makeSharedGlobalRef(env, listener);
+  session->serviceUnregistered.connect([gListener](unsigned int QI_UNUSED(id), const std::string &name) {
+    qi::jni::JNIAttach attach;
+    JNIEnv *env = attach.get();
+    jstring jname = qi::jni::toJstring(name);
+    qi::jni::Call<void>::invoke(env, gListener.get(), "onServiceUnregistered", "(Ljava/lang/String;)V", jname);
+    qi::jni::releaseString(jname);
+  });
+}
+
 class Java_ClientAuthenticator : public qi::ClientAuthenticator
 {
 public:
@@ -0,0 +1,191 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include <signaloperator.hpp>
+
+namespace qi {
+  namespace jni {
+
+    namespace
+    {
+      // Only int and float arguments are aggregated, the others go through untouched
+      bool toNumber(qi::AnyReference arg, double& value)
+      {
+        while (arg.type() && arg.kind() == qi::TypeKind_Dynamic)
+          arg = arg.content();
+        if (!arg.type() || (arg.kind() != qi::TypeKind_Int && arg.kind() != qi::TypeKind_Float))
+          return false;
+        value = arg.toDouble();
+        return true;
+      }
+
+      class Decimate : public SignalOperator
+      {
+      public:
+        explicit Decimate(std::size_t factor)
+          : _factor(factor)
+          , _count(0)
+        {}
+
+        bool apply(std::vector<qi::AnyReference>&, std::deque<qi::AnyValue>&, qi::SteadyClock::time_point) override
+        {
+          // keeps the first one
+          return _count++ % _factor == 0;
+        }
+
+      private:
+        const std::size_t _factor;
+        std::size_t _count;
+      };
+
+      class RateLimit : public SignalOperator
+      {
+      public:
+        explicit RateLimit(qi::Duration period)
+          : _period(period)
+          , _passed(false)
+        {}
+
+        bool apply(std::vector<qi::AnyReference>&, std::deque<qi::AnyValue>&, qi::SteadyClock::time_point time) override
+        {
+          if (_passed && time - _last < _period)
+            return false;
+          _passed = true;
+          _last = time;
+          return true;
+        }
+
+      private:
+        const qi::Duration _period;
+        bool _passed;
+        qi::SteadyClock::time_point _last;
+      };
+
+      class Window : public SignalOperator
+      {
+      public:
+        Window(std::size_t size, SignalOperatorKind aggregate)
+          : _size(size)
+          , _aggregate(aggregate)
+        {}
+
+        bool apply(std::vector<qi::AnyReference>& args, std::deque<qi::AnyValue>& storage, qi::SteadyClock::time_point) override
+        {
+          if (_windows.size() < args.size())
+            _windows.resize(args.size());
+
+          for (std::size_t i = 0; i < args.size(); ++i)
+          {
+            double value;
+            if (!toNumber(args[i], value))
+              continue;
+
+            std::deque<double>& window = _windows[i];
+            window.push_back(value);
+            if (window.size() > _size)
+              window.pop_front();
+
+            storage.push_back(qi::AnyValue::from(aggregate(window)));
+            args[i] = storage.back().asReference();
+          }
+          return true;
+        }
+
+      private:
+        double aggregate(const std::deque<double>& window) const
+        {
+          switch (_aggregate)
+          {
+          case SignalOperatorKind_WindowMin:
+            return *std::min_element(window.begin(), window.end());
+          case SignalOperatorKind_WindowMax:
+            return *std::max_element(window.begin(), window.end());
+          default:
+            return std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+          }
+        }
+
+        const std::size_t _size;
+        const SignalOperatorKind _aggregate;
+        // last values of each argument
+        std::vector<std::deque<double>> _windows;
+      };
+
+      class Deadband : public SignalOperator
+      {
+      public:
+        explicit Deadband(double threshold)
+          : _threshold(threshold)
+          , _passed(false)
+        {}
+
+        bool apply(std::vector<qi::AnyReference>& args, std::deque<qi::AnyValue>&, qi::SteadyClock::time_point) override
+        {
+          std::vector<double> values(args.size(), NAN);
+          bool numeric = false;
+          bool changed = !_passed || _last.size() != args.size();
+          for (std::size_t i = 0; i < args.size(); ++i)
+          {
+            if (!toNumber(args[i], values[i]))
+              continue;
+            numeric = true;
+            // a value becoming or ceasing to be NaN is a change, NaN staying NaN is not
+            if (!changed && (std::isnan(_last[i]) != std::isnan(values[i])
+                             || std::fabs(values[i] - _last[i]) > _threshold))
+              changed = true;
+          }
+
+          // nothing to compare, let it through
+          if (!numeric)
+            return true;
+          if (!changed)
+            return false;
+          _passed = true;
+          _last.swap(values);
+          return true;
+        }
+
+      private:
+        const double _threshold;
+        bool _passed;
+        // values of the last emission let through
+        std::vector<double> _last;
+      };
+    }
+
+    SignalOperatorPtr makeSignalOperator(int kind, double parameter)
+    {
+      switch (kind)
+      {
+      case SignalOperatorKind_Decimate:
+        if (parameter < 1)
+          throw std::invalid_argument("decimation factor must be at least 1");
+        return SignalOperatorPtr(new Decimate(static_cast<std::size_t>(parameter)));
+      case SignalOperatorKind_RateLimit:
+        if (!(parameter > 0))
+          throw std::invalid_argument("rate limit must be positive");
+        return SignalOperatorPtr(new RateLimit(qi::Duration(static_cast<qi::Duration::rep>(1e9 / parameter))));
+      case SignalOperatorKind_WindowMean:
+      case SignalOperatorKind_WindowMin:
+      case SignalOperatorKind_WindowMax:
+        if (parameter < 1)
+          throw std::invalid_argument("window size must be at least 1");
+        return SignalOperatorPtr(new Window(static_cast<std::size_t>(parameter), static_cast<SignalOperatorKind>(kind)));
+      case SignalOperatorKind_Deadband:
+        if (!(parameter >= 0))
+          throw std::invalid_argument("deadband must not be negative");
+        return SignalOperatorPtr(new Deadband(parameter));
+      default:
+        throw std::invalid_argument("unknown signal operator");
+      }
+    }
+  }// !jni
+}// !qi
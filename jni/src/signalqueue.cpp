@@ -0,0 +1,192 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <algorithm>
+#include <iterator>
+
+#include <qi/log.hpp>
+#include <qi/future.hpp>
+
+#include <signalqueue.hpp>
+
+qiLogCategory("qimessaging.jni");
+
+namespace qi {
+  namespace jni {
+
+    SignalQueue::SignalQueue(JNIEnv* env, jobject listener, std::size_t maxBatchSize, qi::Duration maxLatency, std::size_t capacity,
+                             std::vector<SignalOperatorPtr> operators)
+      : _listener(makeSharedGlobalRef(env, listener))
+      , _maxBatchSize(std::max<std::size_t>(maxBatchSize, 1))
+      , _maxLatency(maxLatency)
+      , _capacity(capacity)
+      , _dropped(0)
+      , _operators(std::move(operators))
+      , _flushQueued(false)
+      , _timerArmed(false)
+      , _delivering(false)
+      , _closed(false)
+    {
+      // looked up once, not for each batch
+      jclass cls = env->GetObjectClass(listener);
+      _onSignalsReceived = env->GetMethodID(cls, "onSignalsReceived", "([[Ljava/lang/Object;)V");
+      env->DeleteLocalRef(cls);
+    }
+
+    void SignalQueue::push(const std::vector<qi::AnyReference>& args)
+    {
+      Emission emission;
+      emission.time = qi::SteadyClock::now();
+
+      // the operators work on the raw arguments, the dropped emissions are never copied
+      std::vector<qi::AnyReference> reduced(args);
+      std::deque<qi::AnyValue> storage;
+      if (!_operators.empty())
+      {
+        Lock lock(_operatorsMutex);
+        for (const SignalOperatorPtr& op : _operators)
+        {
+          if (!op->apply(reduced, storage, emission.time))
+            return;
+        }
+      }
+
+      emission.args.reserve(reduced.size());
+      for (const qi::AnyReference& arg : reduced)
+        emission.args.emplace_back(arg);
+
+      Lock lock(_mutex);
+      if (_closed)
+        return;
+      if (_capacity && _pending.size() >= _capacity)
+      {
+        _pending.pop_front();
+        ++_dropped;
+      }
+      _pending.push_back(std::move(emission));
+      schedule(lock);
+    }
+
+    std::uint64_t SignalQueue::dropped() const
+    {
+      return _dropped.load();
+    }
+
+    void SignalQueue::close()
+    {
+      Lock lock(_mutex);
+      _closed = true;
+      _pending.clear();
+      // the listener may disconnect itself while it receives a batch
+      while (_delivering && _deliveringThread != std::this_thread::get_id())
+        _delivered.wait(lock);
+    }
+
+    bool SignalQueue::ready() const
+    {
+      if (_closed || _pending.empty())
+        return false;
+      return _pending.size() >= _maxBatchSize
+          || qi::SteadyClock::now() - _pending.front().time >= _maxLatency;
+    }
+
+    void SignalQueue::schedule(Lock& QI_UNUSED(lock))
+    {
+      // the running delivery reschedules what it leaves
+      if (_delivering || _pending.empty())
+        return;
+
+      std::weak_ptr<SignalQueue> weakSelf = shared_from_this();
+      if (_pending.size() >= _maxBatchSize)
+      {
+        if (_flushQueued)
+          return;
+        _flushQueued = true;
+        qi::async([weakSelf] {
+          if (auto self = weakSelf.lock())
+          {
+            Lock lock(self->_mutex);
+            self->_flushQueued = false;
+            self->deliver(lock);
+          }
+        });
+      }
+      else if (!_timerArmed)
+      {
+        _timerArmed = true;
+        const qi::Duration age = qi::SteadyClock::now() - _pending.front().time;
+        const qi::Duration delay = age < _maxLatency ? _maxLatency - age : qi::Duration(0);
+        qi::asyncDelay([weakSelf] {
+          if (auto self = weakSelf.lock())
+          {
+            Lock lock(self->_mutex);
+            self->_timerArmed = false;
+            self->deliver(lock);
+          }
+        }, delay);
+      }
+    }
+
+    void SignalQueue::deliver(Lock& lock)
+    {
+      if (_delivering)
+        return;
+
+      _delivering = true;
+      _deliveringThread = std::this_thread::get_id();
+      while (ready())
+      {
+        const std::size_t count = std::min(_pending.size(), _maxBatchSize);
+        std::vector<Emission> batch(std::make_move_iterator(_pending.begin()),
+                                    std::make_move_iterator(_pending.begin() + count));
+        _pending.erase(_pending.begin(), _pending.begin() + count);
+
+        lock.unlock();
+        toJava(batch);
+        lock.lock();
+      }
+      _delivering = false;
+      _deliveringThread = std::thread::id();
+      _delivered.notify_all();
+      schedule(lock);
+    }
+
+    void SignalQueue::toJava(const std::vector<Emission>& batch)
+    {
+      qi::jni::JNIAttach attach;
+      JNIEnv* env = attach.get();
+
+      try
+      {
+        jobjectArray jbatch = env->NewObjectArray(batch.size(), cls_objectArray, nullptr);
+        std::vector<qi::AnyReference> args;
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+          args.clear();
+          for (const qi::AnyValue& arg : batch[i].args)
+            args.push_back(arg.asReference());
+          jobjectArray jargs = toJobjectArray(args);
+          env->SetObjectArrayElement(jbatch, static_cast<jsize>(i), jargs);
+          env->DeleteLocalRef(jargs);
+        }
+
+        env->CallVoidMethod(_listener.get(), _onSignalsReceived, jbatch);
+        env->DeleteLocalRef(jbatch);
+      }
+      catch (std::exception& e)
+      {
+        qiLogError() << "Cannot deliver " << batch.size() << " signal emissions: " << e.what();
+      }
+
+      if (env->ExceptionCheck())
+      {
+        env->ExceptionDescribe();
+        // an exception occurred in a listener, report and ignore
+        env->ExceptionClear();
+      }
+    }
+  }// !jni
+}// !qi
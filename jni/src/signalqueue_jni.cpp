@@ -0,0 +1,57 @@
+/*
+**
+** Copyright (C) 2015 Aldebaran Robotics
+** See COPYING for the license
+*/
+
+#include <stdexcept>
+
+#include <qi/macro.hpp>
+
+#include <jnitools.hpp>
+#include <signalqueue.hpp>
+#include <signalqueue_jni.hpp>
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueCreate(JNIEnv* env, jobject QI_UNUSED(obj), jobject listener, jint maxBatchSize, jlong maxLatencyMicros, jint capacity,
+                                                                              jintArray operatorKinds, jdoubleArray operatorParameters)
+{
+  const jsize count = env->GetArrayLength(operatorKinds);
+  std::vector<jint> kinds(count);
+  std::vector<jdouble> parameters(count);
+  if (count)
+  {
+    env->GetIntArrayRegion(operatorKinds, 0, count, kinds.data());
+    env->GetDoubleArrayRegion(operatorParameters, 0, count, parameters.data());
+  }
+
+  std::vector<qi::jni::SignalOperatorPtr> operators;
+  try
+  {
+    for (jsize i = 0; i < count; ++i)
+      operators.push_back(qi::jni::makeSignalOperator(kinds[i], parameters[i]));
+  }
+  catch (const std::invalid_argument& e)
+  {
+    throwNew(env, "java/lang/IllegalArgumentException", e.what());
+    return 0;
+  }
+
+  auto queue = std::make_shared<qi::jni::SignalQueue>(env, listener, maxBatchSize, qi::MicroSeconds(maxLatencyMicros), capacity,
+                                                      std::move(operators));
+  return reinterpret_cast<jlong>(new qi::jni::SignalQueuePtr(queue));
+}
+
+JNIEXPORT jlong JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueDropped(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pQueue)
+{
+  return static_cast<jlong>(qi::jni::signalQueueFromPointer(pQueue)->dropped());
+}
+
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueClose(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pQueue)
+{
+  qi::jni::signalQueueFromPointer(pQueue)->close();
+}
+
+JNIEXPORT void JNICALL Java_com_aldebaran_qi_SignalQueue_qiSignalQueueDestroy(JNIEnv* QI_UNUSED(env), jobject QI_UNUSED(obj), jlong pQueue)
+{
+  delete &qi::jni::signalQueueFromPointer(pQueue);
+}
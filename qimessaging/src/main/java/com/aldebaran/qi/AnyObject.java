@@ -8,6 +8,12 @@ import java.lang.reflect.InvocationTargetException;
 import java.lang.reflect.Method;
 import java.lang.reflect.Type;
 import java.util.Arrays;
+import java.util.HashMap;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.CopyOnWriteArrayList;
+import java.util.concurrent.TimeUnit;
 
 import com.aldebaran.qi.serialization.QiSerializer;
 
@@ -38,10 +44,17 @@ public class AnyObject {
 
     private final long _p;
 
+    // Native subscriptions shared by the listeners of each signal
+    private final Map<String, SharedSignal> sharedSignals = new HashMap<String, SharedSignal>();
+
     private native long property(long pObj, String property) throws DynamicCallException;
 
     private native long setProperty(long pObj, String property, Object value) throws DynamicCallException;
 
+    private native long properties(long pObj, String[] properties) throws DynamicCallException;
+
+    private native long setProperties(long pObj, String[] properties, Object[] values) throws DynamicCallException;
+
     private native long asyncCall(long pObject, String method, Object[] args) throws DynamicCallException;
 
     private native String printMetaObject(long pObject);
@@ -55,6 +68,11 @@ public class AnyObject {
 
     private native long connectSignal(long pObject, String signalName, QiSignalListener listener);
 
+    private native long connectSignalPrimitive(long pObject, String signalName, Object listener, Method method,
+            String parameterDescriptors);
+
+    private native long connectSignalQueue(long pObject, String signalName, long pQueue);
+
     private native long disconnectSignal(long pObject, long subscriberId);
 
     private native long post(long pObject, String name, Object[] args);
@@ -76,6 +94,7 @@ public class AnyObject {
         try {
             // convert custom structs to tuples if necessary
             Object convertedProperty = serializer.serialize(o);
+            invalidateLastValue(property);
             return new Future<Void>(setProperty(_p, property, convertedProperty));
         }
         catch (QiConversionException e) {
@@ -87,8 +106,114 @@ public class AnyObject {
         return setProperty(QiSerializer.getDefault(), property, o);
     }
 
+    /**
+     * Set many properties at once: all the writes are sent in a single native
+     * call, without waiting for each other.
+     *
+     * @param serializer
+     *            the serializer converting custom structs to tuples
+     * @param values
+     *            the value of each property to set
+     * @return a future finished once all the properties are set, or as soon
+     *         as one of the writes fails
+     */
+    public Future<Void> setProperties(QiSerializer serializer, Map<String, ?> values) {
+        String[] properties = new String[values.size()];
+        Object[] convertedValues = new Object[values.size()];
+        int i = 0;
+        try {
+            for (Map.Entry<String, ?> entry : values.entrySet()) {
+                properties[i] = entry.getKey();
+                // convert custom structs to tuples if necessary
+                convertedValues[i] = serializer.serialize(entry.getValue());
+                ++i;
+            }
+        }
+        catch (QiConversionException e) {
+            throw new QiRuntimeException(e);
+        }
+
+        for (String property : properties) {
+            invalidateLastValue(property);
+        }
+
+        return new Future<Void>(setProperties(_p, properties, convertedValues));
+    }
+
+    public Future<Void> setProperties(Map<String, ?> values) {
+        return setProperties(QiSerializer.getDefault(), values);
+    }
+
+    /**
+     * Read many properties at once: all the reads are sent in a single native
+     * call, without waiting for each other.
+     *
+     * @param properties
+     *            the properties to read
+     * @return a future to the value of each property, in the given order, or
+     *         failing as soon as one of the reads fails
+     */
+    public Future<Map<String, Object>> getProperties(final String... properties) {
+        return new Future<List<Object>>(properties(_p, properties)).andThenApply(
+                new Function<List<Object>, Map<String, Object>>() {
+                    @Override
+                    public Map<String, Object> execute(List<Object> values) {
+                        Map<String, Object> result = new LinkedHashMap<String, Object>();
+                        for (int i = 0; i < properties.length; ++i) {
+                            result.put(properties[i], values.get(i));
+                        }
+                        return result;
+                    }
+                }, FutureCallbackType.Sync);
+    }
+
+    /**
+     * Retrieve the value of {@code property} asynchronously.
+     * <p>
+     * If a last-value cache is enabled for this property and holds a value
+     * fresh enough, it is returned without any call.
+     *
+     * @param property
+     *            the property
+     * @return a future to the value
+     * @see #enableLastValueCache(String, long, TimeUnit)
+     */
+    @SuppressWarnings("unchecked")
     public <T> Future<T> property(String property) {
-        return new Future<T>(property(_p, property));
+        final SharedSignal shared;
+        synchronized (sharedSignals) {
+            shared = sharedSignals.get(property);
+        }
+
+        if (shared == null || !shared.cached) {
+            return new Future<T>(property(_p, property));
+        }
+
+        LastValue last = shared.freshLastValue();
+        if (last != null && last.args.length == 1) {
+            return Future.of((T) last.args[0]);
+        }
+
+        final long readTime = System.nanoTime();
+        return new Future<T>(property(_p, property)).andThenApply(new Function<T, T>() {
+            @Override
+            public T execute(T value) {
+                shared.updateLastValue(new Object[] { value }, readTime);
+                return value;
+            }
+        }, FutureCallbackType.Sync);
+    }
+
+    /**
+     * Mirror {@code property} locally: its value is read once, then updated on
+     * each change, and can be read without any call.
+     *
+     * @param property
+     *            the property
+     * @return the mirror, to close when it is no longer needed
+     */
+    public <T> PropertyMirror<T> mirrorProperty(String property) {
+        return new PropertyMirror<T>(this, property);
     }
 
     /**
@@ -140,6 +265,28 @@ public class AnyObject {
         return new Future<T>(asyncCall(_p, method, args));
     }
 
+    /**
+     * Perform asynchronous call with a deadline and return Future return
+     * value. If the call is not finished after {@code timeout}, it is
+     * cancelled and the future fails with a
+     * {@link java.util.concurrent.TimeoutException}.
+     *
+     * @param timeout
+     *            Maximum duration of the call
+     * @param unit
+     *            Time unit of the timeout argument
+     * @param method
+     *            Method name to call
+     * @param args
+     *            Arguments to be forward to remote method
+     * @return Future method return value
+     * @throws DynamicCallException
+     * @see Future#withTimeout(long, TimeUnit)
+     */
+    public <T> Future<T> callWithTimeout(long timeout, TimeUnit unit, String method, Object... args) {
+        return this.<T> call(method, args).withTimeout(timeout, unit);
+    }
+
     /**
      * Convert structs in {@code args} to tuples if necessary, then call
      * {@code method} asynchronously. Tuples will be converted to structs in the
@@ -213,9 +360,275 @@ public class AnyObject {
         throw new QiRuntimeException("Cannot find " + callback + " in object " + object);
     }
 
+    /**
+     * Connect a listener to {@code signalName}.
+     * <p>
+     * All the listeners of a signal of this object share a single native
+     * subscription: the arguments of each emission are converted to Java
+     * objects once, and the same array is given to every listener, which must
+     * not modify it. The subscription is released when its last listener is
+     * disconnected.
+     * <p>
+     * The listeners of a signal are called one after the other, on the thread
+     * delivering the emission: a slow listener delays the others. An exception
+     * thrown by a listener does not deprive the others of the emission, it is
+     * reported by the native layer as for a listener of its own subscription.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param listener
+     *            Listener receiving the emissions
+     * @return the connection
+     */
     public QiSignalConnection connect(String signalName, QiSignalListener listener) {
-        long futurePtr = connectSignal(_p, signalName, listener);
-        return new QiSignalConnection(this, new Future<Long>(futurePtr));
+        final SharedSignal shared;
+        final SharedListener sharedListener = new SharedListener(listener);
+        synchronized (sharedSignals) {
+            shared = sharedSignal(signalName);
+            shared.listeners.add(sharedListener);
+        }
+
+        LastValue last = shared.freshLastValue();
+        if (last != null) {
+            // late subscriber, give it the current state, unless it already
+            // received a more recent emission
+            sharedListener.deliver(last, true);
+        }
+
+        return new QiSignalConnection(this, shared.link, signalName, sharedListener);
+    }
+
+    /**
+     * Keep the last emission of a signal, or the last value of a property.
+     * <p>
+     * The cache is kept current by the subscription shared by the listeners
+     * of {@code name}, which it keeps alive until
+     * {@link #disableLastValueCache(String)}. While the cached value is no
+     * older than {@code maxStaleness}, it is given to each new listener when
+     * it connects, and returned by {@link #property(String)} without any call.
+     *
+     * @param name
+     *            Name of the signal or of the property
+     * @param maxStaleness
+     *            Maximum age of a cached value to be used
+     * @param unit
+     *            Time unit of the maxStaleness argument
+     * @see #connect(String, QiSignalListener)
+     */
+    public void enableLastValueCache(String name, long maxStaleness, TimeUnit unit) {
+        synchronized (sharedSignals) {
+            SharedSignal shared = sharedSignal(name);
+            shared.maxStalenessNanos = unit.toNanos(maxStaleness);
+            shared.cached = true;
+        }
+    }
+
+    /**
+     * Drop the last-value cache of a signal or of a property, and its
+     * subscription if no listener uses it.
+     *
+     * @param name
+     *            Name of the signal or of the property
+     * @return a future finishing once the subscription is released
+     */
+    public Future<Void> disableLastValueCache(String name) {
+        synchronized (sharedSignals) {
+            SharedSignal shared = sharedSignals.get(name);
+
+            if (shared == null || !shared.cached) {
+                return Future.of(null);
+            }
+
+            shared.cached = false;
+            shared.lastValue = null;
+
+            if (!shared.listeners.isEmpty()) {
+                return Future.of(null);
+            }
+
+            sharedSignals.remove(name);
+        }
+
+        return disconnectShared(shared.link);
+    }
+
+    /**
+     * Drop the cached value of a property being written, so that it is not
+     * returned by {@link #property(String)} until the next change is received.
+     */
+    private void invalidateLastValue(String property) {
+        final SharedSignal shared;
+        synchronized (sharedSignals) {
+            shared = sharedSignals.get(property);
+        }
+
+        if (shared != null) {
+            shared.invalidateLastValue(System.nanoTime());
+        }
+    }
+
+    /**
+     * Get the shared subscription to a signal, subscribing if needed. Must be
+     * called with {@code sharedSignals} locked.
+     */
+    private SharedSignal sharedSignal(String signalName) {
+        SharedSignal shared = sharedSignals.get(signalName);
+
+        if (shared == null || (shared.link.isDone() && !shared.link.isSuccess())) {
+            // first use, or the previous subscription failed
+            SharedSignal previous = shared;
+            shared = new SharedSignal();
+            if (previous != null) {
+                // the listeners of the failed subscription are not connected
+                shared.cached = previous.cached;
+                shared.maxStalenessNanos = previous.maxStalenessNanos;
+            }
+            shared.link = new Future<Long>(connectSignal(_p, signalName, shared));
+            sharedSignals.put(signalName, shared);
+        }
+
+        return shared;
+    }
+
+    /**
+     * Connect a listener to {@code signalName}, applying {@code policy} to the
+     * emissions it does not keep up with.
+     * <p>
+     * Unlike {@link #connect(String, QiSignalListener)}, the emissions wait in
+     * a native queue, and are delivered one at a time from a thread of the
+     * event loop.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param listener
+     *            Listener receiving the emissions
+     * @param policy
+     *            Policy applied to the pending emissions
+     * @return the connection, counting the dropped emissions
+     * @see QiSignalConnection#getDroppedCount()
+     */
+    public QiSignalConnection connect(String signalName, QiSignalListener listener, SignalDeliveryPolicy policy) {
+        return connect(signalName, listener, SignalOperators.NONE, policy);
+    }
+
+    /**
+     * Connect a listener to {@code signalName}, reducing its emissions with
+     * {@code operators} in the native layer, then applying {@code policy} to
+     * the ones it does not keep up with.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param listener
+     *            Listener receiving the reduced emissions
+     * @param operators
+     *            Operators applied to the emissions
+     * @param policy
+     *            Policy applied to the pending emissions
+     * @return the connection, counting the dropped emissions
+     * @see #connect(String, QiSignalListener, SignalDeliveryPolicy)
+     */
+    public QiSignalConnection connect(String signalName, final QiSignalListener listener, SignalOperators operators,
+            SignalDeliveryPolicy policy) {
+        QiSignalBatchListener batchListener = new QiSignalBatchListener() {
+            @Override
+            public void onSignalsReceived(Object[][] batch) {
+                for (Object[] args : batch) {
+                    listener.onSignalReceived(args);
+                }
+            }
+        };
+        return connect(signalName, new SignalQueue(batchListener, 1, 0, operators, policy));
+    }
+
+    /**
+     * Connect a listener receiving the emissions of {@code signalName} in
+     * batches.
+     * <p>
+     * The emissions are queued by the native layer, and delivered from a
+     * thread of the event loop as soon as {@code maxBatchSize} of them are
+     * pending, or once the oldest pending one waited for {@code maxLatency}.
+     * Batches are delivered one at a time, in order. Emissions still pending
+     * when the connection is disconnected are dropped: once
+     * {@link QiSignalConnection#disconnect()} returns, the listener is not
+     * called any more.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param listener
+     *            Listener receiving the batches
+     * @param maxBatchSize
+     *            Maximum number of emissions per batch
+     * @param maxLatency
+     *            Maximum time an emission waits before being delivered
+     * @param unit
+     *            Time unit of the maxLatency argument
+     * @return the connection
+     */
+    public QiSignalConnection connect(String signalName, QiSignalBatchListener listener, int maxBatchSize,
+            long maxLatency, TimeUnit unit) {
+        return connect(signalName, listener, maxBatchSize, maxLatency, unit, SignalDeliveryPolicy.unbounded());
+    }
+
+    /**
+     * Connect a listener receiving the emissions of {@code signalName} in
+     * batches, applying {@code policy} to the emissions waiting for their
+     * batch to be delivered.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param listener
+     *            Listener receiving the batches
+     * @param maxBatchSize
+     *            Maximum number of emissions per batch
+     * @param maxLatency
+     *            Maximum time an emission waits before being delivered
+     * @param unit
+     *            Time unit of the maxLatency argument
+     * @param policy
+     *            Policy applied to the pending emissions
+     * @return the connection, counting the dropped emissions
+     * @see #connect(String, QiSignalBatchListener, int, long, TimeUnit)
+     */
+    public QiSignalConnection connect(String signalName, QiSignalBatchListener listener, int maxBatchSize,
+            long maxLatency, TimeUnit unit, SignalDeliveryPolicy policy) {
+        return connect(signalName, listener, maxBatchSize, maxLatency, unit, SignalOperators.NONE, policy);
+    }
+
+    /**
+     * Connect a listener receiving the emissions of {@code signalName} in
+     * batches, once reduced by {@code operators} in the native layer.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param listener
+     *            Listener receiving the batches
+     * @param maxBatchSize
+     *            Maximum number of emissions per batch
+     * @param maxLatency
+     *            Maximum time an emission waits before being delivered
+     * @param unit
+     *            Time unit of the maxLatency argument
+     * @param operators
+     *            Operators applied to the emissions
+     * @param policy
+     *            Policy applied to the pending emissions
+     * @return the connection, counting the dropped emissions
+     * @see #connect(String, QiSignalBatchListener, int, long, TimeUnit,
+     *      SignalDeliveryPolicy)
+     */
+    public QiSignalConnection connect(String signalName, QiSignalBatchListener listener, int maxBatchSize,
+            long maxLatency, TimeUnit unit, SignalOperators operators, SignalDeliveryPolicy policy) {
+        if (maxBatchSize <= 0) {
+            throw new IllegalArgumentException("maxBatchSize must be positive");
+        }
+
+        return connect(signalName,
+                new SignalQueue(listener, maxBatchSize, unit.toMicros(maxLatency), operators, policy));
+    }
+
+    private QiSignalConnection connect(String signalName, SignalQueue queue) {
+        long futurePtr = connectSignalQueue(_p, signalName, queue.pointer());
+        return new QiSignalConnection(this, new Future<Long>(futurePtr), queue);
     }
 
     public QiSignalConnection connect(final QiSerializer serializer, String signalName, final Object annotatedSlotContainer,
@@ -258,6 +671,70 @@ public class AnyObject {
         return connect(QiSerializer.getDefault(), signalName, annotatedSlotContainer, slotName);
     }
 
+    /**
+     * Connect a slot whose parameters are all primitive to a signal with a
+     * numeric signature, for instance {@code onSignal(float x, float y,
+     * float z)} to a signal {@code (fff)}.
+     * <p>
+     * The slot is checked against the signal signature once, here. Each
+     * emission is then given directly to the slot by the native layer,
+     * without boxing the arguments nor allocating any Java object.
+     * <p>
+     * The slot parameters must match the signal parameters exactly:
+     * {@code boolean} for {@code b}, {@code byte} for {@code c} and
+     * {@code C}, {@code short} for {@code w} and {@code W}, {@code int} for
+     * {@code i} and {@code I}, {@code long} for {@code l} and {@code L},
+     * {@code float} for {@code f} and {@code double} for {@code d}. Unsigned
+     * values keep their bits.
+     *
+     * @param signalName
+     *            Name of the signal
+     * @param annotatedSlotContainer
+     *            Object containing the slot
+     * @param slotName
+     *            Name of the slot, as defined by its {@link QiSlot}
+     *            annotation
+     * @return the connection
+     * @throws QiSlotException
+     *             if the slot is not found or does not match the signal
+     */
+    public QiSignalConnection connectPrimitive(String signalName, Object annotatedSlotContainer, String slotName) {
+        final Method method = findSlot(annotatedSlotContainer, slotName);
+
+        if (method == null)
+            throw new QiSlotException("Slot \"" + slotName + "\" not found in " + annotatedSlotContainer.getClass().getName()
+                    + " (did you forget the @QiSlot annotation?)");
+
+        StringBuilder descriptors = new StringBuilder();
+        for (Class<?> type : method.getParameterTypes()) {
+            char descriptor = primitiveDescriptor(type);
+            if (descriptor == 0)
+                throw new QiSlotException("Slot " + method + " has a non-primitive parameter " + type.getName());
+            descriptors.append(descriptor);
+        }
+
+        long futurePtr = connectSignalPrimitive(_p, signalName, annotatedSlotContainer, method, descriptors.toString());
+        return new QiSignalConnection(this, new Future<Long>(futurePtr), null);
+    }
+
+    private static char primitiveDescriptor(Class<?> type) {
+        if (type == boolean.class)
+            return 'Z';
+        if (type == byte.class)
+            return 'B';
+        if (type == short.class)
+            return 'S';
+        if (type == int.class)
+            return 'I';
+        if (type == long.class)
+            return 'J';
+        if (type == float.class)
+            return 'F';
+        if (type == double.class)
+            return 'D';
+        return 0;
+    }
+
     private static Class<?>[] getTypes(Object[] values) {
         Class<?>[] types = new Class[values.length];
         for (int i = 0; i < types.length; ++i) {
@@ -268,7 +745,37 @@ public class AnyObject {
     }
 
     Future<Void> disconnect(QiSignalConnection connection) {
-        return connection.getFuture().andThenCompose(new Function<Long, Future<Void>>() {
+        final String signalName = connection.getSharedSignalName();
+
+        if (signalName != null) {
+            synchronized (sharedSignals) {
+                SharedSignal shared = sharedSignals.get(signalName);
+
+                if (shared == null || shared.link != connection.getFuture()
+                        || !shared.listeners.remove(connection.getSharedListener())) {
+                    // already disconnected
+                    return Future.of(null);
+                }
+
+                if (!shared.listeners.isEmpty() || shared.cached) {
+                    return Future.of(null);
+                }
+
+                sharedSignals.remove(signalName);
+            }
+        }
+
+        final SignalQueue queue = connection.getQueue();
+        if (queue != null) {
+            // the pending emissions are not delivered after disconnection
+            queue.close();
+        }
+
+        return disconnectShared(connection.getFuture());
+    }
+
+    private Future<Void> disconnectShared(Future<Long> link) {
+        return link.andThenCompose(new Function<Long, Future<Void>>() {
             @Override
             public Future<Void> execute(Long value) throws Throwable {
                 return new Future<Void>(disconnectSignal(_p, value));
@@ -315,6 +822,121 @@ public class AnyObject {
         super.finalize();
     }
 
+    /**
+     * Arguments of an emission, and the time it was received.
+     */
+    private static class LastValue {
+        private final Object[] args;
+        private final long nanos;
+
+        LastValue(Object[] args, long nanos) {
+            this.args = args;
+            this.nanos = nanos;
+        }
+    }
+
+    /**
+     * Native subscription to a signal, forwarding each emission to all its
+     * listeners.
+     */
+    private static class SharedSignal implements QiSignalListener {
+        private final List<SharedListener> listeners = new CopyOnWriteArrayList<SharedListener>();
+        // future of native SignalLink
+        private Future<Long> link;
+        // last-value cache
+        private volatile boolean cached;
+        private volatile long maxStalenessNanos;
+        private volatile LastValue lastValue;
+        // values read before this time are outdated by a write
+        private boolean invalidated;
+        private long invalidatedNanos;
+
+        LastValue freshLastValue() {
+            LastValue last = lastValue;
+            if (!cached || last == null || System.nanoTime() - last.nanos > maxStalenessNanos) {
+                return null;
+            }
+            return last;
+        }
+
+        synchronized void updateLastValue(Object[] args, long nanos) {
+            updateLastValue(new LastValue(args, nanos));
+        }
+
+        private synchronized void updateLastValue(LastValue value) {
+            if (invalidated && value.nanos - invalidatedNanos < 0) {
+                // read before a write
+                return;
+            }
+            // an emission received during a property read is more recent
+            if (cached && (lastValue == null || lastValue.nanos <= value.nanos)) {
+                lastValue = value;
+            }
+        }
+
+        synchronized void invalidateLastValue(long nanos) {
+            invalidated = true;
+            invalidatedNanos = nanos;
+            lastValue = null;
+        }
+
+        @Override
+        public void onSignalReceived(Object... args) {
+            LastValue value = new LastValue(args, System.nanoTime());
+            updateLastValue(value);
+            RuntimeException failure = null;
+            for (SharedListener listener : listeners) {
+                try {
+                    listener.deliver(value, false);
+                }
+                catch (RuntimeException e) {
+                    // do not deprive the other listeners of the emission
+                    if (failure == null) {
+                        failure = e;
+                    }
+                }
+            }
+
+            if (failure != null) {
+                // reported by the native layer, as for an unshared listener
+                throw failure;
+            }
+        }
+    }
+
+    /**
+     * Listener of a shared subscription, given the emissions and the cached
+     * value one at a time, so that the cached value given when it connects
+     * never overwrites a more recent emission.
+     */
+    private static class SharedListener implements QiSignalListener {
+        private final QiSignalListener listener;
+        // most recent emission given to the listener
+        private LastValue delivered;
+
+        SharedListener(QiSignalListener listener) {
+            this.listener = listener;
+        }
+
+        synchronized void deliver(LastValue value, boolean replay) {
+            if (value == delivered || (replay && delivered != null && value.nanos - delivered.nanos <= 0)) {
+                // already given, or older than what was given
+                return;
+            }
+
+            if (delivered == null || value.nanos - delivered.nanos > 0) {
+                delivered = value;
+            }
+
+            listener.onSignalReceived(value.args);
+        }
+
+        @Override
+        public void onSignalReceived(Object... args) {
+            deliver(new LastValue(args, System.nanoTime()), false);
+        }
+    }
+
     private static Method findSlot(Object annotatedSlotContainer, String slotName) {
         Class<?> clazz = annotatedSlotContainer.getClass();
         Method slot = null;
@@ -0,0 +1,205 @@
+package com.aldebaran.qi;
+
+import java.io.Closeable;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Queue collecting the completions of many {@link Future}s, to process them
+ * in batches from a single thread.
+ * <p>
+ * Each registered future is identified by a user tag. When it finishes, the
+ * native layer pushes its tag and its result in the queue without calling
+ * into Java. {@link #drain(long[], int[], Object[], long, TimeUnit)} then
+ * moves many completions to Java in a single call.
+ * <p>
+ * Closing the queue wakes up the threads draining it, their drain throws an
+ * {@link IllegalStateException}.
+ */
+public class CompletionQueue implements Closeable {
+
+    // Loading QiMessaging JNI layer
+    static {
+        if (!EmbeddedTools.LOADED_EMBEDDED_LIBRARY) {
+            EmbeddedTools loader = new EmbeddedTools();
+            loader.loadEmbeddedLibraries();
+        }
+    }
+
+    /**
+     * State of a future that finished with a value, the result is the value.
+     */
+    public static final int VALUE = 0;
+
+    /**
+     * State of a future that finished with an error, the result is the error
+     * message.
+     */
+    public static final int ERROR = 1;
+
+    /**
+     * State of a future that was cancelled, the result is {@code null}.
+     */
+    public static final int CANCELLED = 2;
+
+    // C++ completion queue, 0 once closed
+    private volatile long queuePtr;
+
+    // Native calls running on the C++ queue, guarded by this: closing the
+    // queue defers its destruction to the last of them, kept in closedPtr
+    // meanwhile
+    private int nativeCalls;
+    private long closedPtr;
+
+    private native long qiCompletionQueueCreate();
+
+    private native void qiCompletionQueueRegister(long pQueue, Future<?> future, long tag);
+
+    private native int qiCompletionQueueDrain(long pQueue, long[] tags, int[] states, Object[] results, long msecs);
+
+    private native void qiCompletionQueueClose(long pQueue);
+
+    private native void qiCompletionQueueDestroy(long pQueue);
+
+    public CompletionQueue() {
+        this.queuePtr = this.qiCompletionQueueCreate();
+    }
+
+    /**
+     * Report the completion of {@code future} in this queue.
+     *
+     * @param future
+     *            the future to watch
+     * @param tag
+     *            the tag reported with its completion
+     */
+    public void register(Future<?> future, long tag) {
+        final long pointer = this.acquire();
+
+        try {
+            this.qiCompletionQueueRegister(pointer, future, tag);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Move the available completions to the given arrays, oldest first,
+     * waiting for at least one if there is none.
+     *
+     * @param tags
+     *            receives the tags of the finished futures, its length is the
+     *            maximum number of completions to move
+     * @param states
+     *            receives the states of the finished futures ({@link #VALUE},
+     *            {@link #ERROR} or {@link #CANCELLED})
+     * @param results
+     *            receives the results of the finished futures
+     * @param timeout
+     *            the maximum time to wait, 0 to return immediately
+     * @param unit
+     *            the time unit of the timeout argument
+     * @return the number of completions moved, 0 on timeout
+     * @throws IllegalStateException
+     *             if the queue is closed, before or while waiting
+     */
+    public int drain(long[] tags, int[] states, Object[] results, long timeout, TimeUnit unit) {
+        return this.drain(tags, states, results, unit.toMillis(timeout));
+    }
+
+    /**
+     * Move the available completions to the given arrays, oldest first,
+     * waiting as long as necessary for at least one.
+     *
+     * @see #drain(long[], int[], Object[], long, TimeUnit)
+     */
+    public int drain(long[] tags, int[] states, Object[] results) {
+        return this.drain(tags, states, results, -1);
+    }
+
+    private int drain(long[] tags, int[] states, Object[] results, long msecs) {
+        if (states.length < tags.length || results.length < tags.length) {
+            throw new IllegalArgumentException("states and results must be at least as long as tags");
+        }
+
+        final long pointer = this.acquire();
+
+        try {
+            return this.qiCompletionQueueDrain(pointer, tags, states, results, msecs);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Get the native queue pointer for a native call, which must be followed
+     * by {@link #release()}: a concurrent {@link #close()} destroys the
+     * native queue once all these calls returned.
+     *
+     * @return the native queue pointer
+     * @throws IllegalStateException
+     *             if this queue has been closed
+     */
+    private synchronized long acquire() {
+        final long pointer = this.queuePtr;
+
+        if (pointer == 0) {
+            throw new IllegalStateException("CompletionQueue already closed");
+        }
+
+        this.nativeCalls++;
+        return pointer;
+    }
+
+    /**
+     * End a native call started by {@link #acquire()}, destroying the native
+     * queue if it was closed meanwhile and no other call is running.
+     */
+    private void release() {
+        final long pointer;
+
+        synchronized (this) {
+            if (--this.nativeCalls > 0 || this.closedPtr == 0) {
+                return;
+            }
+
+            pointer = this.closedPtr;
+            this.closedPtr = 0;
+        }
+
+        this.qiCompletionQueueDestroy(pointer);
+    }
+
+    /**
+     * Release the native queue. The completions not drained yet are lost,
+     * the threads draining it are woken up and fail. Calling it several times
+     * has no effect.
+     */
+    @Override
+    public void close() {
+        final long pointer;
+
+        synchronized (this) {
+            pointer = this.queuePtr;
+            this.queuePtr = 0;
+
+            if (pointer != 0 && this.nativeCalls > 0) {
+                // wake up the drainers, the last of them destroys the queue
+                this.qiCompletionQueueClose(pointer);
+                this.closedPtr = pointer;
+                return;
+            }
+        }
+
+        if (pointer != 0) {
+            this.qiCompletionQueueDestroy(pointer);
+        }
+    }
+
+    @Override
+    protected void finalize() throws Throwable {
+        this.close();
+        super.finalize();
+    }
+}
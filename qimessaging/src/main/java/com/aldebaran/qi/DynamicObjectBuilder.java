@@ -39,6 +39,14 @@ public class DynamicObjectBuilder {
     private native void advertiseMethod(long pObjectBuilder, String method, Object instance, String className,
                                         String description) throws AdvertisementException;
 
+    /**
+     * Advertise a method returning a {@link Future}. The native future is
+     * forwarded to the caller as soon as the method returns, the calling
+     * thread does not wait for its completion.
+     */
+    private native void advertiseAsyncMethod(long pObjectBuilder, String method, Object instance, String className,
+                                             String description) throws AdvertisementException;
+
     private native void advertiseSignal(long pObjectBuilder, String eventSignature) throws AdvertisementException;
 
     private native void advertiseProperty(long pObjectBuilder, String name, Class<?> propertyBase)
@@ -149,6 +157,8 @@ public class DynamicObjectBuilder {
      * <li>If method choose (by name) have not the correct Java signature, it
      * will crash later (when call)</li>
      * </ul>
+     * Methods returning a {@link Future} are called asynchronously: the
+     * calling thread is released as soon as the future is returned.
      *
      * @param methodSignature Signature of method to bind. It must be a valid libqi type
      *                        signature
@@ -166,7 +176,11 @@ public class DynamicObjectBuilder {
             // FIXME this is very fragile
             // If method name match signature
             if (methodSignature.contains(method.getName())) {
-                advertiseMethod(_p, methodSignature, service, serviceClassName, description);
+                if (isAsynchronous(method)) {
+                    advertiseAsyncMethod(_p, methodSignature, service, serviceClassName, description);
+                } else {
+                    advertiseMethod(_p, methodSignature, service, serviceClassName, description);
+                }
                 return;
             }
         }
@@ -266,11 +280,27 @@ public class DynamicObjectBuilder {
                 description = advertisedMethodDescription.value();
             }
 
-            this.advertiseMethod(this._p, SignatureUtilities.computeSignatureForMethod(method), monitor,
-                    interfaceClass.getName(), description);
+            if (isAsynchronous(method)) {
+                this.advertiseAsyncMethod(this._p, SignatureUtilities.computeSignatureForMethod(method), monitor,
+                        interfaceClass.getName(), description);
+            } else {
+                this.advertiseMethod(this._p, SignatureUtilities.computeSignatureForMethod(method), monitor,
+                        interfaceClass.getName(), description);
+            }
         }
 
         return (INTERFACE) Proxy.newProxyInstance(interfaceClass.getClassLoader(), new Class<?>[]{interfaceClass},
                 new AdvertisedMethodCaller<INTERFACE>(this, advertisedMethodMonitor));
     }
+
+    /**
+     * Indicates if given method returns a {@link Future}, so it can be
+     * advertised as asynchronous.
+     *
+     * @param method Method to test
+     * @return {@code true} if the method returns a {@link Future}
+     */
+    private static boolean isAsynchronous(final Method method) {
+        return Future.class.isAssignableFrom(method.getReturnType());
+    }
 }
@@ -3,8 +3,14 @@
  */
 package com.aldebaran.qi;
 
+import java.io.Closeable;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.List;
 import java.util.concurrent.CancellationException;
 import java.util.concurrent.ExecutionException;
+import java.util.concurrent.Executor;
 import java.util.concurrent.TimeUnit;
 import java.util.concurrent.TimeoutException;
 
@@ -21,7 +27,7 @@ import java.util.concurrent.TimeoutException;
  * @param <T>
  *            The type of the result
  */
-public class Future<T> implements java.util.concurrent.Future<T> {
+public class Future<T> implements java.util.concurrent.Future<T>, Closeable {
 
     // Loading QiMessaging JNI layer
     static {
@@ -37,26 +43,73 @@ public class Future<T> implements java.util.concurrent.Future<T> {
 
     private static final int TIMEOUT_INFINITE = -1;
 
-    // C++ Future
-    private final long _fut;
+    // C++ Future, 0 once closed
+    private volatile long _fut;
+
+    // Native calls running without the monitor of this future, guarded by
+    // it: closing the future defers the destruction of the C++ future to the
+    // last of them, kept in closedFut meanwhile
+    private int nativeCalls;
+    private long closedFut;
+    private int closedStateSlot = NO_STATE_SLOT;
+
+    // Set once the C++ future is referenced by another future or by native
+    // code, in which case it must not be cancelled on collection
+    private volatile boolean _shared;
+
+    private volatile boolean cancelOnCollect;
+
+    // Value converted by the first successful get(), valid once valueCached
+    private T cachedValue;
+    private volatile boolean valueCached;
+
+    private volatile boolean releaseOnGet;
+
+    // Index of the state word of this future in States.BUFFER, NO_STATE_SLOT
+    // if it has none, UNASSIGNED_STATE_SLOT until it is first polled
+    private volatile int stateSlot = UNASSIGNED_STATE_SLOT;
+
+    private static final int UNASSIGNED_STATE_SLOT = -2;
+    private static final int NO_STATE_SLOT = -1;
+
+    // keep values synchronized with qi::jni::FutureStateWord in futurestate.hpp
+    private static final int STATE_RUNNING = 0;
+    private static final int STATE_CANCELLED = 3;
+    private static final int STATE_MASK = 3;
+
+    /**
+     * State words of the polled futures, written by native code when they
+     * finish, so that polling them does not cross JNI.
+     */
+    private static final class States {
+        static final ByteBuffer BUFFER = qiFutureStateBuffer().order(ByteOrder.nativeOrder());
+    }
 
     // Native C API object functions
     private native boolean qiFutureCallCancel(long pFuture);
 
-    private native boolean qiFutureCallCancelRequest(long pFuture);
+    private native void qiFutureCallCancelRequest(long pFuture);
+
+    private native void qiFutureCallAbandon(long pFuture);
 
     private native Object qiFutureCallGet(long pFuture, int msecs) throws ExecutionException, TimeoutException;
 
-    private native boolean qiFutureCallIsCancelled(long pFuture);
+    private static native boolean qiFutureCallIsCancelled(long pFuture);
 
-    private native boolean qiFutureCallIsDone(long pFuture);
+    private static native boolean qiFutureCallIsDone(long pFuture);
 
     private native void qiFutureCallWaitWithTimeout(long pFuture, int timeout);
 
-    private native void qiFutureDestroy(long pFuture);
+    private static native void qiFutureDestroy(long pFuture, int stateSlot);
+
+    private static native ByteBuffer qiFutureStateBuffer();
+
+    private native int qiFutureStateSlot(long pFuture);
 
     private native void qiFutureCallConnectCallback(long pFuture, Callback<?> callback, int futureCallbackType);
 
+    private native void qiFutureCompleteInto(long pFuture, Object completableFuture);
+
     /**
      * Call native future "andThen" for Function(P)->R
      *
@@ -64,9 +117,11 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *            Future pointer
      * @param function
      *            Function to callback
+     * @param futureCallbackType
+     *            How to call the function
      * @return Pointer of created future
      */
-    private native long qiFutureAndThen(long future, Function<T, ?> function);
+    private native long qiFutureAndThen(long future, Function<T, ?> function, int futureCallbackType);
 
     /**
      * Call native future "andThen" for Consumer(P)
@@ -75,9 +130,11 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *            Future pointer
      * @param consumer
      *            Function to callback
+     * @param futureCallbackType
+     *            How to call the function
      * @return Pointer of created future
      */
-    private native long qiFutureAndThenVoid(long future, Consumer<T> consumer);
+    private native long qiFutureAndThenVoid(long future, Consumer<T> consumer, int futureCallbackType);
 
     /**
      * Call native future "andThen" for Function(P)->Future&lt;R&gt; and unwrap
@@ -87,9 +144,25 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *            Future pointer
      * @param futureOfFutureFunction
      *            Function to callback
+     * @param futureCallbackType
+     *            How to call the function
      * @return Pointer of created future
      */
-    private native long qiFutureAndThenUnwrap(long future, Function<T, ?> futureOfFutureFunction);
+    private native long qiFutureAndThenUnwrap(long future, Function<T, ?> futureOfFutureFunction, int futureCallbackType);
+
+    /**
+     * Call native future "andThen" once for a chain of Function(P)->R
+     *
+     * @param future
+     *            Future pointer
+     * @param functions
+     *            Functions to call in a row, each one receiving the result of
+     *            the previous one
+     * @param futureCallbackType
+     *            How to call the chain
+     * @return Pointer of created future
+     */
+    private native long qiFutureAndThenChain(long future, Object[] functions, int futureCallbackType);
 
     /**
      * Call native future <b>then</b> for Function(Future&lt;P&gt;)->R
@@ -98,9 +171,11 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *            Future pointer
      * @param function
      *            Function to callback
+     * @param futureCallbackType
+     *            How to call the function
      * @return Pointer on created future
      */
-    private native long qiFutureThen(long future, Function<Future<T>, ?> futureFunction);
+    private native long qiFutureThen(long future, Function<Future<T>, ?> futureFunction, int futureCallbackType);
 
     /**
      * Call native future <b>then</b> for Consumer(Future&lt;P&gt;)
@@ -109,9 +184,11 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *            Future pointer
      * @param function
      *            Function to callback
+     * @param futureCallbackType
+     *            How to call the function
      * @return Pointer on created future
      */
-    private native long qiFutureThenVoid(long future, Consumer<Future<T>> futureFunction);
+    private native long qiFutureThenVoid(long future, Consumer<Future<T>> futureFunction, int futureCallbackType);
 
     /**
      * Call native future <b>then</b> for
@@ -121,9 +198,48 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *            Future pointer
      * @param function
      *            Function to callback
+     * @param futureCallbackType
+     *            How to call the function
      * @return Pointer on created future
      */
-    private native long qiFutureThenUnwrap(long future, Function<Future<T>, ?> futureOfFutureFunction);
+    private native long qiFutureThenUnwrap(long future, Function<Future<T>, ?> futureOfFutureFunction, int futureCallbackType);
+
+    /**
+     * Combine native futures: the created future finishes when all of them
+     * finish successfully, or as soon as one of them fails
+     *
+     * @param futures
+     *            Futures pointers
+     * @param collectValues
+     *            Indicates if the created future carries the list of values
+     * @return Pointer on created future
+     */
+    private static native long qiFutureWhenAll(long[] futures, boolean collectValues);
+
+    /**
+     * Combine native futures: the created future takes the state of the first
+     * of them to finish
+     *
+     * @param futures
+     *            Futures pointers
+     * @param keepValue
+     *            Indicates if the created future carries the value of the
+     *            first finished future
+     * @return Pointer on created future
+     */
+    private static native long qiFutureWhenAny(long[] futures, boolean keepValue);
+
+    /**
+     * Create a native future failing on timeout if the given one is not
+     * finished in time
+     *
+     * @param future
+     *            Future pointer
+     * @param msecs
+     *            Delay in milliseconds
+     * @return Pointer on created future
+     */
+    private native long qiFutureWithTimeout(long future, long msecs);
 
     /**
      * Default callback type
@@ -163,7 +279,14 @@ public class Future<T> implements java.util.concurrent.Future<T> {
     }
 
     public void sync(long timeout, TimeUnit unit) {
-        qiFutureCallWaitWithTimeout(_fut, (int) unit.toMillis(timeout));
+        final long pointer = this.acquire();
+
+        try {
+            qiFutureCallWaitWithTimeout(pointer, (int) unit.toMillis(timeout));
+        }
+        finally {
+            this.release();
+        }
     }
 
     public void sync() {
@@ -174,18 +297,71 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      * Prefer {@link #then(FutureFunction, FutureCallbackType)} instead (e.g.
      */
     public void connect(Callback<T> callback, FutureCallbackType futureCallbackType) {
-        qiFutureCallConnectCallback(_fut, callback, futureCallbackType.nativeValue);
+        final long pointer = this.acquireShared();
+
+        try {
+            qiFutureCallConnectCallback(pointer, callback, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
     }
 
     public void connect(final Callback<T> callback) {
         this.connect(callback, this.defaultFutureCallbackType);
     }
 
+    /**
+     * Complete a {@code java.util.concurrent.CompletableFuture} with the
+     * state of this future when it finishes.
+     * <p>
+     * It is completed directly by the native layer, without creating a
+     * callback nor looking its methods up for each completion. An error
+     * completes it exceptionally with the same exception as {@link #get()}
+     * would throw in an {@link ExecutionException}, a cancellation cancels it.
+     * <p>
+     * The {@code CompletableFuture} is completed synchronously, on the libqi
+     * thread that finishes this future: its non-async dependents run on that
+     * thread too, so long running ones should use the {@code ...Async}
+     * variants.
+     *
+     * @param completableFuture
+     *            the {@code CompletableFuture<? super T>} to complete (typed
+     *            as {@code Object}, this library targets Java 6)
+     * @throws UnsupportedOperationException
+     *             if {@code CompletableFuture} is not available on this JVM
+     * @throws IllegalArgumentException
+     *             if {@code completableFuture} is not a
+     *             {@code CompletableFuture}
+     */
+    public void completeInto(Object completableFuture) {
+        if (completableFuture == null) {
+            throw new NullPointerException("completableFuture MUST NOT be null!");
+        }
+
+        final long pointer = this.acquireShared();
+
+        try {
+            qiFutureCompleteInto(pointer, completableFuture);
+        }
+        finally {
+            this.release();
+        }
+    }
+
     @Override
     public boolean cancel(boolean mayInterruptIfRunning) {
         // ignore mayInterruptIfRunning, can't map it to native libqi
         // This must be a blocking call to be compliant with Java's Future
-        qiFutureCallCancel(_fut);
+        final long pointer = this.acquire();
+
+        try {
+            qiFutureCallCancel(pointer);
+        }
+        finally {
+            this.release();
+        }
+
         sync();
         return isCancelled();
     }
@@ -195,7 +371,7 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      */
     public synchronized void requestCancellation() {
         // This call is compliant with native libqi's Future.cancel()
-        qiFutureCallCancelRequest(_fut);
+        qiFutureCallCancelRequest(pointer());
     }
 
     @Deprecated
@@ -204,13 +380,29 @@ public class Future<T> implements java.util.concurrent.Future<T> {
         // sense)
         // to avoid breaking projects that were already using it.
         // Future projects should prefer using requestCancellation().
-        return qiFutureCallCancel(_fut);
+        return qiFutureCallCancel(pointer());
     }
 
     @SuppressWarnings("unchecked")
     private T get(int msecs) throws ExecutionException, TimeoutException {
+        if (this.valueCached) {
+            return this.cachedValue;
+        }
+
+        final long pointer;
+
+        synchronized (this) {
+            // another consumer may have got the value, and released the
+            // native future, meanwhile
+            if (this.valueCached) {
+                return this.cachedValue;
+            }
+
+            pointer = this.acquire();
+        }
+
         try {
-            return (T) qiFutureCallGet(_fut, msecs);
+            return this.cacheValue((T) qiFutureCallGet(pointer, msecs));
         }
         catch (Exception exception) {
             Throwable throwable = exception;
@@ -240,6 +432,37 @@ public class Future<T> implements java.util.concurrent.Future<T> {
             Exception newException = NativeTools.obtainRealException(exception);
             throw new ExecutionException(newException.getMessage(), newException);
         }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Keep the value converted by the first successful get, so that the next
+     * calls return it without converting it again.
+     * <p>
+     * If the native future is to be released on get, it is closed: it is
+     * destroyed once the other consumers still waiting for it returned.
+     *
+     * @param value
+     *            the converted value
+     * @return the value kept, converted by the first get to return
+     */
+    private T cacheValue(T value) {
+        synchronized (this) {
+            if (this.valueCached) {
+                return this.cachedValue;
+            }
+
+            this.cachedValue = value;
+            this.valueCached = true;
+        }
+
+        if (this.releaseOnGet) {
+            this.close();
+        }
+
+        return value;
     }
 
     @Override
@@ -248,8 +471,9 @@ public class Future<T> implements java.util.concurrent.Future<T> {
             return get(TIMEOUT_INFINITE);
         }
         catch (TimeoutException e) {
-            // should never happen
-            throw new RuntimeException(e);
+            // only happens when the deadline of a future created by
+            // withTimeout(…) expired
+            throw new ExecutionException(e.getMessage(), e);
         }
     }
 
@@ -332,12 +556,73 @@ public class Future<T> implements java.util.concurrent.Future<T> {
         // i.e. it must return true after any successful call to cancel(…)
         // --> There is no way to verify that a cancel request resulted in the
         // cancellation of the associated task, until the Future is done
-        return qiFutureCallIsCancelled(_fut);
+        if (this.valueCached) {
+            return false;
+        }
+
+        final int slot = this.stateSlot();
+
+        if (slot >= 0) {
+            return this.state(slot) == STATE_CANCELLED;
+        }
+
+        return qiFutureCallIsCancelled(pointer());
     }
 
     @Override
     public synchronized boolean isDone() {
-        return qiFutureCallIsDone(_fut);
+        if (this.valueCached) {
+            return true;
+        }
+
+        final int slot = this.stateSlot();
+
+        if (slot >= 0) {
+            return this.state(slot) != STATE_RUNNING;
+        }
+
+        return qiFutureCallIsDone(pointer());
+    }
+
+    /**
+     * Get the index of the state word of this future, asking one to the
+     * native layer when it is first polled.
+     *
+     * @return the index of the state word, or {@link #NO_STATE_SLOT} if all
+     *         of them are used
+     * @throws IllegalStateException
+     *             if this future has been closed
+     */
+    private int stateSlot() {
+        int slot = this.stateSlot;
+
+        if (slot == UNASSIGNED_STATE_SLOT) {
+            synchronized (this) {
+                slot = this.stateSlot;
+
+                if (slot == UNASSIGNED_STATE_SLOT) {
+                    slot = this.qiFutureStateSlot(this.pointer());
+                    this.stateSlot = slot;
+                }
+            }
+        }
+
+        return slot;
+    }
+
+    /**
+     * Read the state written by the native layer in the given state word.
+     *
+     * @param slot
+     *            the index of the state word of this future
+     * @return the state
+     * @throws IllegalStateException
+     *             if this future has been closed
+     */
+    private int state(int slot) {
+        // the slot may be given to another future once this one is closed
+        this.pointer();
+        return States.BUFFER.getInt(slot * 4) & STATE_MASK;
     }
 
     public synchronized boolean isSuccess() {
@@ -357,10 +642,49 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *         task link to this future and given function) status
      */
     public <R> Future<R> thenApply(final Function<Future<T>, R> function) {
-        final long futurePointer = this.qiFutureThen(this._fut, function);
+        return this.thenApply(function, FutureCallbackType.Async);
+    }
+
+    /**
+     * Same as {@link #thenApply(Function)}, with the given way to call the
+     * function: {@link FutureCallbackType#Sync} runs it on the thread that
+     * finishes this future, so consecutive synchronous steps of a chain stay
+     * on the same thread.
+     *
+     * @param function
+     *            Function to call
+     * @param futureCallbackType
+     *            how to call the function
+     * @return future of the function result
+     */
+    public <R> Future<R> thenApply(final Function<Future<T>, R> function, final FutureCallbackType futureCallbackType) {
+        final long futurePointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            futurePointer = this.qiFutureThen(pointer, function, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
+
         return new Future<R>(futurePointer);
     }
 
+    /**
+     * Same as {@link #thenApply(Function)}, with the function run by the given
+     * executor.
+     *
+     * @param function
+     *            Function to call
+     * @param executor
+     *            executor running the function
+     * @return future of the function result
+     */
+    public <R> Future<R> thenApply(final Function<Future<T>, R> function, final Executor executor) {
+        return this.thenCompose(onExecutor(applied(function), executor), FutureCallbackType.Sync);
+    }
+
     /**
      * Launch a task when the task link when this future finished (succeed,
      * error or cancelled)
@@ -372,10 +696,49 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *         task link to this future and given ) status
      */
     public Future<Void> thenConsume(final Consumer<Future<T>> consumer) {
-        final long futurePointer = this.qiFutureThenVoid(this._fut, consumer);
+        return this.thenConsume(consumer, FutureCallbackType.Async);
+    }
+
+    /**
+     * Same as {@link #thenConsume(Consumer)}, with the given way to call the
+     * consumer: {@link FutureCallbackType#Sync} runs it on the thread that
+     * finishes this future, so consecutive synchronous steps of a chain stay
+     * on the same thread.
+     *
+     * @param consumer
+     *            Consumer to call
+     * @param futureCallbackType
+     *            how to call the consumer
+     * @return future finished when the consumer returns
+     */
+    public Future<Void> thenConsume(final Consumer<Future<T>> consumer, final FutureCallbackType futureCallbackType) {
+        final long futurePointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            futurePointer = this.qiFutureThenVoid(pointer, consumer, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
+
         return new Future<Void>(futurePointer);
     }
 
+    /**
+     * Same as {@link #thenConsume(Consumer)}, with the consumer run by the given
+     * executor.
+     *
+     * @param consumer
+     *            Consumer to call
+     * @param executor
+     *            executor running the consumer
+     * @return future finished when the consumer returns
+     */
+    public Future<Void> thenConsume(final Consumer<Future<T>> consumer, final Executor executor) {
+        return this.thenCompose(onExecutor(consumed(consumer), executor), FutureCallbackType.Sync);
+    }
+
     /**
      * Launch a task when the task link when this future finished (succeed,
      * error or cancelled).<br>
@@ -391,8 +754,47 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *         task link to this future and given ) status
      */
     public <R> Future<R> thenCompose(final Function<Future<T>, Future<R>> function) {
-        final long pointer = this.qiFutureThenUnwrap(this._fut, function);
-        return new Future<R>(pointer);
+        return this.thenCompose(function, FutureCallbackType.Async);
+    }
+
+    /**
+     * Same as {@link #thenCompose(Function)}, with the given way to call the
+     * function: {@link FutureCallbackType#Sync} runs it on the thread that
+     * finishes this future, so consecutive synchronous steps of a chain stay
+     * on the same thread.
+     *
+     * @param function
+     *            Function to call
+     * @param futureCallbackType
+     *            how to call the function
+     * @return future of the function result
+     */
+    public <R> Future<R> thenCompose(final Function<Future<T>, Future<R>> function, final FutureCallbackType futureCallbackType) {
+        final long resultPointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            resultPointer = this.qiFutureThenUnwrap(pointer, function, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
+
+        return new Future<R>(resultPointer);
+    }
+
+    /**
+     * Same as {@link #thenCompose(Function)}, with the function run by the given
+     * executor.
+     *
+     * @param function
+     *            Function to call
+     * @param executor
+     *            executor running the function
+     * @return future of the function result
+     */
+    public <R> Future<R> thenCompose(final Function<Future<T>, Future<R>> function, final Executor executor) {
+        return this.thenCompose(onExecutor(function, executor), FutureCallbackType.Sync);
     }
 
     /**
@@ -407,10 +809,49 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *         task link to this future and given function) status
      */
     public <R> Future<R> andThenApply(final Function<T, R> function) {
-        final long futurePointer = this.qiFutureAndThen(this._fut, function);
+        return this.andThenApply(function, FutureCallbackType.Async);
+    }
+
+    /**
+     * Same as {@link #andThenApply(Function)}, with the given way to call the
+     * function: {@link FutureCallbackType#Sync} runs it on the thread that
+     * finishes this future, so consecutive synchronous steps of a chain stay
+     * on the same thread.
+     *
+     * @param function
+     *            Function to call
+     * @param futureCallbackType
+     *            how to call the function
+     * @return future of the function result
+     */
+    public <R> Future<R> andThenApply(final Function<T, R> function, final FutureCallbackType futureCallbackType) {
+        final long futurePointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            futurePointer = this.qiFutureAndThen(pointer, function, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
+
         return new Future<R>(futurePointer);
     }
 
+    /**
+     * Same as {@link #andThenApply(Function)}, with the function run by the given
+     * executor.
+     *
+     * @param function
+     *            Function to call
+     * @param executor
+     *            executor running the function
+     * @return future of the function result
+     */
+    public <R> Future<R> andThenApply(final Function<T, R> function, final Executor executor) {
+        return this.andThenCompose(onExecutor(applied(function), executor), FutureCallbackType.Sync);
+    }
+
     /**
      * Launch a task when the task link when this future succeed only
      *
@@ -421,10 +862,49 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *         task link to this future and given ) status
      */
     public Future<Void> andThenConsume(final Consumer<T> consumer) {
-        final long futurePointer = this.qiFutureAndThenVoid(this._fut, consumer);
+        return this.andThenConsume(consumer, FutureCallbackType.Async);
+    }
+
+    /**
+     * Same as {@link #andThenConsume(Consumer)}, with the given way to call the
+     * consumer: {@link FutureCallbackType#Sync} runs it on the thread that
+     * finishes this future, so consecutive synchronous steps of a chain stay
+     * on the same thread.
+     *
+     * @param consumer
+     *            Consumer to call
+     * @param futureCallbackType
+     *            how to call the consumer
+     * @return future finished when the consumer returns
+     */
+    public Future<Void> andThenConsume(final Consumer<T> consumer, final FutureCallbackType futureCallbackType) {
+        final long futurePointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            futurePointer = this.qiFutureAndThenVoid(pointer, consumer, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
+
         return new Future<Void>(futurePointer);
     }
 
+    /**
+     * Same as {@link #andThenConsume(Consumer)}, with the consumer run by the given
+     * executor.
+     *
+     * @param consumer
+     *            Consumer to call
+     * @param executor
+     *            executor running the consumer
+     * @return future finished when the consumer returns
+     */
+    public Future<Void> andThenConsume(final Consumer<T> consumer, final Executor executor) {
+        return this.andThenCompose(onExecutor(consumed(consumer), executor), FutureCallbackType.Sync);
+    }
+
     /**
      * Launch a task when the task link when this future succeed only.<br>
      * Instead of return a Future<Future<R>>, it will automatically unwrap the
@@ -439,8 +919,177 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      *         task link to this future and given ) status
      */
     public <R> Future<R> andThenCompose(final Function<T, Future<R>> function) {
-        final long pointer = this.qiFutureAndThenUnwrap(this._fut, function);
-        return new Future<R>(pointer);
+        return this.andThenCompose(function, FutureCallbackType.Async);
+    }
+
+    /**
+     * Same as {@link #andThenCompose(Function)}, with the given way to call the
+     * function: {@link FutureCallbackType#Sync} runs it on the thread that
+     * finishes this future, so consecutive synchronous steps of a chain stay
+     * on the same thread.
+     *
+     * @param function
+     *            Function to call
+     * @param futureCallbackType
+     *            how to call the function
+     * @return future of the function result
+     */
+    public <R> Future<R> andThenCompose(final Function<T, Future<R>> function, final FutureCallbackType futureCallbackType) {
+        final long resultPointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            resultPointer = this.qiFutureAndThenUnwrap(pointer, function, futureCallbackType.nativeValue);
+        }
+        finally {
+            this.release();
+        }
+
+        return new Future<R>(resultPointer);
+    }
+
+    /**
+     * Same as {@link #andThenCompose(Function)}, with the function run by the given
+     * executor.
+     *
+     * @param function
+     *            Function to call
+     * @param executor
+     *            executor running the function
+     * @return future of the function result
+     */
+    public <R> Future<R> andThenCompose(final Function<T, Future<R>> function, final Executor executor) {
+        return this.andThenCompose(onExecutor(function, executor), FutureCallbackType.Sync);
+    }
+
+    /**
+     * Start a chain of functions to call when this future succeeds.
+     * <p>
+     * Unlike consecutive {@link #andThenApply(Function)} calls, the whole
+     * chain is given to the native layer at once when
+     * {@link Chain#submit()} is called: the functions are called in a row by
+     * a single task, and only the result of the last one is held by a native
+     * future.
+     *
+     * @return an empty chain
+     */
+    public Chain<T> chain() {
+        return new Chain<T>(this, new ArrayList<Function<?, ?>>());
+    }
+
+    /**
+     * Builder of a chain of functions called in a row when a future succeeds.
+     * <p>
+     * Each call adds a stage to the same chain, so a chain must be built
+     * linearly and submitted once.
+     *
+     * @param <T>
+     *            Type of the result of the last stage
+     */
+    public static final class Chain<T> {
+        private final Future<?> source;
+        private final List<Function<?, ?>> functions;
+
+        private Chain(final Future<?> source, final List<Function<?, ?>> functions) {
+            this.source = source;
+            this.functions = functions;
+        }
+
+        /**
+         * Add a function to the chain.
+         *
+         * @param <R>
+         *            Function result type
+         * @param function
+         *            Function receiving the result of the previous stage
+         * @return the chain
+         */
+        public <R> Chain<R> andThenApply(final Function<T, R> function) {
+            this.functions.add(function);
+            return new Chain<R>(this.source, this.functions);
+        }
+
+        /**
+         * Add a consumer to the chain.
+         *
+         * @param consumer
+         *            Consumer receiving the result of the previous stage
+         * @return the chain
+         */
+        public Chain<Void> andThenConsume(final Consumer<T> consumer) {
+            return this.andThenApply(new Function<T, Void>() {
+                @Override
+                public Void execute(T value) throws Throwable {
+                    consumer.consume(value);
+                    return null;
+                }
+            });
+        }
+
+        /**
+         * Attach the chain to the future, its stages being called
+         * asynchronously.
+         *
+         * @return future of the result of the last stage, or of the first
+         *         failure
+         */
+        public Future<T> submit() {
+            return this.submit(FutureCallbackType.Async);
+        }
+
+        /**
+         * Attach the chain to the future.
+         *
+         * @param futureCallbackType
+         *            how to call the stages
+         * @return future of the result of the last stage, or of the first
+         *         failure
+         */
+        public Future<T> submit(final FutureCallbackType futureCallbackType) {
+            final long resultPointer;
+            final long pointer = this.source.acquireShared();
+
+            try {
+                resultPointer = this.source.qiFutureAndThenChain(pointer, this.functions.toArray(),
+                        futureCallbackType.nativeValue);
+            }
+            finally {
+                this.source.release();
+            }
+
+            return new Future<T>(resultPointer);
+        }
+    }
+
+    /**
+     * Return a version of {@code this} future with a deadline.
+     * <p>
+     * If {@code this} future is not finished after {@code timeout}, its
+     * cancellation is requested and the returned future fails: its
+     * {@link #get(long, TimeUnit)} throws a {@link TimeoutException}.
+     * <p>
+     * The deadline is handled by the native event loop, no Java thread waits
+     * for it.
+     *
+     * @param timeout
+     *            the maximum time to wait
+     * @param unit
+     *            the time unit of the timeout argument
+     * @return future finished with the state of {@code this} future, or
+     *         failed on timeout
+     */
+    public Future<T> withTimeout(long timeout, TimeUnit unit) {
+        final long resultPointer;
+        final long pointer = this.acquireShared();
+
+        try {
+            resultPointer = this.qiFutureWithTimeout(pointer, unit.toMillis(timeout));
+        }
+        finally {
+            this.release();
+        }
+
+        return new Future<T>(resultPointer);
     }
 
     /**
@@ -457,52 +1106,190 @@ public class Future<T> implements java.util.concurrent.Future<T> {
      * @return a future waiting for all the others
      */
     public static Future<Void> waitAll(final Future<?>... futures) {
-        if (futures.length == 0)
-            return Future.of(null);
+        final long[] pointers = acquireAll(futures);
+
+        try {
+            return new Future<Void>(qiFutureWhenAll(pointers, false));
+        }
+        finally {
+            releaseAll(futures);
+        }
+    }
+
+    /**
+     * Wait for all {@code futures} to complete and collect their values.
+     * <p>
+     * The returning future finishes successfully if and only if all of the
+     * futures it waits for finish successfully. Its value is the list of their
+     * values, in the same order.
+     * <p>
+     * Otherwise, it takes the state of the first failing future (due to
+     * cancellation or error).
+     *
+     * @param futures
+     *            the futures to wait for
+     * @return a future of the list of values
+     */
+    public static <T> Future<List<T>> allOf(final Future<? extends T>... futures) {
+        final long[] pointers = acquireAll(futures);
+
+        try {
+            return new Future<List<T>>(qiFutureWhenAll(pointers, true));
+        }
+        finally {
+            releaseAll(futures);
+        }
+    }
 
-        class WaitData {
-            int runningFutures = futures.length;
-            boolean stopped;
+    /**
+     * Wait for the first of {@code futures} to complete.
+     * <p>
+     * The returning future takes the state (success, error or cancellation) of
+     * the first future to finish, without its value.
+     *
+     * @param futures
+     *            the futures to wait for
+     * @return a future finished when one of the others is finished
+     */
+    public static Future<Void> waitAny(final Future<?>... futures) {
+        final long[] pointers = acquireAll(futures);
+
+        try {
+            return new Future<Void>(qiFutureWhenAny(pointers, false));
+        }
+        finally {
+            releaseAll(futures);
         }
-        final WaitData waitData = new WaitData();
-        final Promise<Void> promise = new Promise<Void>();
-        promise.setOnCancel(new Promise.CancelRequestCallback<Void>() {
+    }
+
+    /**
+     * Race {@code futures} against each other.
+     * <p>
+     * The returning future takes the state and the value of the first future
+     * to finish.
+     *
+     * @param futures
+     *            the futures to wait for
+     * @return a future of the first available result
+     */
+    public static <T> Future<T> anyOf(final Future<? extends T>... futures) {
+        final long[] pointers = acquireAll(futures);
+
+        try {
+            return new Future<T>(qiFutureWhenAny(pointers, true));
+        }
+        finally {
+            releaseAll(futures);
+        }
+    }
+
+    /**
+     * Adapt {@code function} so that it returns its result through a future.
+     *
+     * @param function
+     *            the function to adapt
+     * @return the adapted function
+     */
+    private static <P, R> Function<P, Future<R>> applied(final Function<P, R> function) {
+        return new Function<P, Future<R>>() {
             @Override
-            public void onCancelRequested(Promise<Void> promise) {
-                for (Future<?> future : futures) {
-                    future.requestCancellation();
-                }
+            public Future<R> execute(P argument) throws Throwable {
+                return Future.of(function.execute(argument));
             }
-        });
+        };
+    }
 
-        for (Future<?> future : futures) {
-            ((Future<Object>) future).connect(new Future.Callback<Object>() {
-                @Override
-                public void onFinished(Future<Object> future) {
-                    synchronized (waitData) {
-                        if (!waitData.stopped) {
-                            if (future.isCancelled()) {
-                                promise.setCancelled();
-                                waitData.stopped = true;
-                            }
-                            else if (future.hasError()) {
-                                promise.setError(future.getErrorMessage());
-                                waitData.stopped = true;
-                            }
-                            else {
-                                waitData.runningFutures--;
-
-                                if (waitData.runningFutures == 0) {
-                                    promise.setValue(null);
-                                }
-                            }
+    /**
+     * Adapt {@code consumer} to a function returning a future of nothing.
+     *
+     * @param consumer
+     *            the consumer to adapt
+     * @return the adapted consumer
+     */
+    private static <P> Function<P, Future<Void>> consumed(final Consumer<P> consumer) {
+        return new Function<P, Future<Void>>() {
+            @Override
+            public Future<Void> execute(P argument) throws Throwable {
+                consumer.consume(argument);
+                return Future.of((Void) null);
+            }
+        };
+    }
+
+    /**
+     * Adapt {@code function} so that it runs on {@code executor}. The adapted
+     * function returns immediately a future of the result.
+     *
+     * @param function
+     *            the function to adapt
+     * @param executor
+     *            the executor running the function
+     * @return the adapted function
+     */
+    private static <P, R> Function<P, Future<R>> onExecutor(final Function<P, Future<R>> function,
+            final Executor executor) {
+        return new Function<P, Future<R>>() {
+            @Override
+            public Future<R> execute(final P argument) {
+                final Promise<R> promise = new Promise<R>();
+                executor.execute(new Runnable() {
+                    @Override
+                    public void run() {
+                        try {
+                            promise.connectFromFuture(function.execute(argument));
+                        }
+                        catch (Throwable throwable) {
+                            final String message = throwable.getMessage();
+                            promise.setError(message != null ? message : throwable.toString());
                         }
                     }
-                }
-            });
+                });
+                return promise.getFuture();
+            }
+        };
+    }
+
+    /**
+     * Collect the native pointers of {@code futures}, with
+     * {@link #acquireShared()}.
+     *
+     * @param futures
+     *            the futures, to give to {@link #releaseAll(Future...)} once
+     *            the native call returned
+     * @return their native pointers
+     * @throws IllegalStateException
+     *             if one of the futures has been closed
+     */
+    private static long[] acquireAll(final Future<?>... futures) {
+        final long[] pointers = new long[futures.length];
+        int index = 0;
+
+        try {
+            for (; index < futures.length; index++) {
+                pointers[index] = futures[index].acquireShared();
+            }
+        }
+        catch (IllegalStateException e) {
+            while (index-- > 0) {
+                futures[index].release();
+            }
+
+            throw e;
         }
 
-        return promise.getFuture();
+        return pointers;
+    }
+
+    /**
+     * End the native call started by {@link #acquireAll(Future...)}.
+     *
+     * @param futures
+     *            the futures
+     */
+    private static void releaseAll(final Future<?>... futures) {
+        for (final Future<?> future : futures) {
+            future.release();
+        }
     }
 
     /**
@@ -538,13 +1325,161 @@ public class Future<T> implements java.util.concurrent.Future<T> {
         });
     }
 
+    /**
+     * Get the native future pointer, for a native call made while holding
+     * the monitor of this future, so that {@link #close()} can not destroy it
+     * meanwhile. Other calls use {@link #acquire()}.
+     *
+     * @return the native future pointer
+     * @throws IllegalStateException
+     *             if this future has been closed
+     */
+    private long pointer() {
+        final long pointer = this._fut;
+
+        if (pointer == 0) {
+            throw new IllegalStateException("Future already closed");
+        }
+
+        return pointer;
+    }
+
+    /**
+     * Get the native future pointer for a native call that may block or run
+     * callbacks, which must be followed by {@link #release()}: a concurrent
+     * {@link #close()} destroys the native future once all these calls
+     * returned.
+     *
+     * @return the native future pointer
+     * @throws IllegalStateException
+     *             if this future has been closed
+     */
+    private synchronized long acquire() {
+        final long pointer = this.pointer();
+        this.nativeCalls++;
+        return pointer;
+    }
+
+    /**
+     * Same as {@link #acquire()}, in order to reference the native future
+     * from another future or from native code.
+     *
+     * @return the native future pointer
+     * @throws IllegalStateException
+     *             if this future has been closed
+     */
+    private synchronized long acquireShared() {
+        final long pointer = this.acquire();
+        this._shared = true;
+        return pointer;
+    }
+
+    /**
+     * End a native call started by {@link #acquire()}, destroying the native
+     * future if it was closed meanwhile and no other call is running.
+     */
+    private void release() {
+        final long pointer;
+        final int slot;
+
+        synchronized (this) {
+            if (--this.nativeCalls > 0 || this.closedFut == 0) {
+                return;
+            }
+
+            pointer = this.closedFut;
+            slot = this.closedStateSlot;
+            this.closedFut = 0;
+            this.closedStateSlot = NO_STATE_SLOT;
+        }
+
+        qiFutureDestroy(pointer, slot);
+    }
+
+    /**
+     * Request the cancellation of the operation if this future is garbage
+     * collected before it finishes.
+     * <p>
+     * Useful for speculative calls whose result may be abandoned: the remote
+     * method is cancelled and its result is not converted. It has no effect
+     * once this future has been chained, combined or passed to native code,
+     * since something else may still wait for the result.
+     *
+     * @return this future
+     */
+    public Future<T> cancelOnCollect() {
+        this.cancelOnCollect = true;
+        return this;
+    }
+
+    /**
+     * Release the native future, and the native value it holds, as soon as
+     * the value has been converted by a successful get.
+     * <p>
+     * The value is then only available through {@link #get()} and its
+     * variants, {@link #isDone()}, {@link #isCancelled()} and
+     * {@link #isSuccess()}. Chaining or combining this future afterwards
+     * throws an {@link IllegalStateException}.
+     *
+     * @return this future
+     */
+    public Future<T> releaseNativeOnGet() {
+        this.releaseOnGet = true;
+
+        if (this.valueCached) {
+            this.close();
+        }
+
+        return this;
+    }
+
+    /**
+     * Release the native future immediately, instead of waiting for the
+     * garbage collector.
+     * <p>
+     * The operation itself is not cancelled and the futures chained to this
+     * one are not affected, but this instance must not be used anymore.
+     * Calling it several times has no effect. If other threads are still
+     * waiting for this future, the native future is released once they
+     * return.
+     */
+    @Override
+    public void close() {
+        final long pointer;
+        final int slot;
+
+        synchronized (this) {
+            pointer = this._fut;
+            slot = this.stateSlot;
+            this._fut = 0;
+            this.stateSlot = NO_STATE_SLOT;
+
+            if (pointer != 0 && this.nativeCalls > 0) {
+                // destroyed by the last of them, in release()
+                this.closedFut = pointer;
+                this.closedStateSlot = slot;
+                return;
+            }
+        }
+
+        if (pointer != 0) {
+            qiFutureDestroy(pointer, slot);
+        }
+    }
+
     /**
      * Called by garbage collector Finalize is overridden to manually delete C++
      * data
      */
     @Override
     protected void finalize() throws Throwable {
-        this.qiFutureDestroy(this._fut);
+        final long pointer = this._fut;
+
+        if (this.cancelOnCollect && !this._shared && pointer != 0) {
+            this.qiFutureCallAbandon(pointer);
+        }
+
+        this.close();
         super.finalize();
     }
 }
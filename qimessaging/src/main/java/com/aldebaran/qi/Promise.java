@@ -1,5 +1,7 @@
 package com.aldebaran.qi;
 
+import java.io.Closeable;
+
 /**
  * Promise is a writable, single assignment container which sets the value of
  * the {@link Future}.
@@ -18,7 +20,7 @@ package com.aldebaran.qi;
  *            The type of the result
  */
 
-public class Promise<T> {
+public class Promise<T> implements Closeable {
 
     // Loading QiMessaging JNI layer
     static {
@@ -39,7 +41,14 @@ public class Promise<T> {
         void onCancelRequested(Promise<T> promise);
     }
 
-    private long promisePtr;
+    // C++ Promise, 0 once closed
+    private volatile long promisePtr;
+
+    // Native calls running on the C++ promise, guarded by this: closing the
+    // promise defers its destruction to the last of them, kept in closedPtr
+    // meanwhile
+    private int nativeCalls;
+    private long closedPtr;
 
     private Future<T> future;
 
@@ -64,7 +73,154 @@ public class Promise<T> {
     }
 
     public void setValue(T value) {
-        _setValue(promisePtr, value);
+        final long pointer = this.acquire();
+
+        try {
+            _setValue(pointer, value);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Set an {@code int} value, for a {@code Promise<Integer>}.
+     * <p>
+     * Like the other typed setters, the native value is built immediately
+     * instead of keeping a reference on a Java object until it is converted.
+     *
+     * @param value
+     *            the value
+     */
+    public void setInt(int value) {
+        final long pointer = this.acquire();
+
+        try {
+            _setInt(pointer, value);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Set a {@code long} value, for a {@code Promise<Long>}.
+     *
+     * @param value
+     *            the value
+     */
+    public void setLong(long value) {
+        final long pointer = this.acquire();
+
+        try {
+            _setLong(pointer, value);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Set a {@code double} value, for a {@code Promise<Double>}.
+     *
+     * @param value
+     *            the value
+     */
+    public void setDouble(double value) {
+        final long pointer = this.acquire();
+
+        try {
+            _setDouble(pointer, value);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Set a string value, for a {@code Promise<String>}.
+     *
+     * @param value
+     *            the value
+     */
+    public void setString(String value) {
+        if (value == null) {
+            throw new NullPointerException("value MUST NOT be null!");
+        }
+
+        final long pointer = this.acquire();
+
+        try {
+            _setString(pointer, value);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Set a raw buffer value, for a {@code Promise<ByteBuffer>}.
+     *
+     * @param value
+     *            the bytes of the buffer, copied
+     */
+    public void setBytes(byte[] value) {
+        if (value == null) {
+            throw new NullPointerException("value MUST NOT be null!");
+        }
+
+        final long pointer = this.acquire();
+
+        try {
+            _setBytes(pointer, value);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Finish successfully a {@code Promise<Void>}.
+     */
+    public void setVoid() {
+        final long pointer = this.acquire();
+
+        try {
+            _setVoid(pointer);
+        }
+        finally {
+            this.release();
+        }
+    }
+
+    /**
+     * Set the values of several promises at once.
+     *
+     * @param promises
+     *            the promises
+     * @param values
+     *            the value of each promise
+     */
+    public static void setValues(Promise<?>[] promises, Object[] values) {
+        if (promises.length != values.length) {
+            throw new IllegalArgumentException("promises and values must have the same length");
+        }
+
+        final long[] pointers = new long[promises.length];
+        int acquired = 0;
+
+        try {
+            for (; acquired < promises.length; acquired++) {
+                pointers[acquired] = promises[acquired].acquire();
+            }
+
+            _setValues(pointers, values);
+        }
+        finally {
+            while (acquired-- > 0) {
+                promises[acquired].release();
+            }
+        }
     }
 
     public void setError(String errorMessage) {
@@ -75,11 +231,25 @@ public class Promise<T> {
             throw new NullPointerException("errorMessage MUST NOT be null!");
         }
 
-        _setError(promisePtr, errorMessage);
+        final long pointer = this.acquire();
+
+        try {
+            _setError(pointer, errorMessage);
+        }
+        finally {
+            this.release();
+        }
     }
 
     public void setCancelled() {
-        _setCancelled(promisePtr);
+        final long pointer = this.acquire();
+
+        try {
+            _setCancelled(pointer);
+        }
+        finally {
+            this.release();
+        }
         // the qi Future must match the semantics of
         // java.util.concurrent.Future, so
         // isCancelled() must return true after any successful call to
@@ -97,7 +267,14 @@ public class Promise<T> {
      *            The callback to call
      */
     public void setOnCancel(CancelRequestCallback<T> callback) {
-        _setOnCancel(promisePtr, callback);
+        final long pointer = this.acquire();
+
+        try {
+            _setOnCancel(pointer, callback);
+        }
+        finally {
+            this.release();
+        }
     }
 
     public void connectFromFuture(Future<T> future) {
@@ -118,6 +295,74 @@ public class Promise<T> {
 
     }
 
+    /**
+     * Get the native promise pointer for a native call, which must be
+     * followed by {@link #release()}: setting the promise may run the
+     * callbacks of its future, and a concurrent {@link #close()} destroys the
+     * native promise once all these calls returned.
+     *
+     * @return the native promise pointer
+     * @throws IllegalStateException
+     *             if this promise has been closed
+     */
+    private synchronized long acquire() {
+        final long pointer = this.promisePtr;
+
+        if (pointer == 0) {
+            throw new IllegalStateException("Promise already closed");
+        }
+
+        this.nativeCalls++;
+        return pointer;
+    }
+
+    /**
+     * End a native call started by {@link #acquire()}, destroying the native
+     * promise if it was closed meanwhile and no other call is running.
+     */
+    private void release() {
+        final long pointer;
+
+        synchronized (this) {
+            if (--this.nativeCalls > 0 || this.closedPtr == 0) {
+                return;
+            }
+
+            pointer = this.closedPtr;
+            this.closedPtr = 0;
+        }
+
+        _destroyPromise(pointer);
+    }
+
+    /**
+     * Release the native promise immediately, instead of waiting for the
+     * garbage collector.
+     * <p>
+     * The associated {@link Future} stays valid, but this promise can not be
+     * used anymore. Calling it several times has no effect. If another thread
+     * is still setting it, the native promise is released once it returns.
+     */
+    @Override
+    public void close() {
+        final long pointer;
+
+        synchronized (this) {
+            pointer = this.promisePtr;
+            this.promisePtr = 0;
+
+            if (pointer != 0 && this.nativeCalls > 0) {
+                // destroyed by the last of them, in release()
+                this.closedPtr = pointer;
+                return;
+            }
+        }
+
+        if (pointer != 0) {
+            _destroyPromise(pointer);
+        }
+    }
+
     /**
      * Called by garbage collector when object destroy.<br>
      * Override to free the reference in JNI.
@@ -127,7 +372,7 @@ public class Promise<T> {
      */
     @Override
     protected void finalize() throws Throwable {
-        this._destroyPromise(this.promisePtr);
+        this.close();
         super.finalize();
     }
 
@@ -137,6 +382,20 @@ public class Promise<T> {
 
     private native void _setValue(long promisePtr, T value);
 
+    private native void _setInt(long promisePtr, int value);
+
+    private native void _setLong(long promisePtr, long value);
+
+    private native void _setDouble(long promisePtr, double value);
+
+    private native void _setString(long promisePtr, String value);
+
+    private native void _setBytes(long promisePtr, byte[] value);
+
+    private native void _setVoid(long promisePtr);
+
+    private static native void _setValues(long[] promisePtrs, Object[] values);
+
     private native void _setError(long promisePtr, String errorMessage);
 
     private native void _setCancelled(long promisePtr);
@@ -149,5 +408,5 @@ public class Promise<T> {
      * @param promisePointer
      *            Pointer to destroy.
      */
-    private native void _destroyPromise(long promisePointer);
+    private static native void _destroyPromise(long promisePointer);
 }
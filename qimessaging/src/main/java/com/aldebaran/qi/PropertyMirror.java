@@ -0,0 +1,78 @@
+package com.aldebaran.qi;
+
+import java.io.Closeable;
+import java.util.concurrent.ExecutionException;
+
+/**
+ * Local copy of a property of an {@link AnyObject}, kept current by its change
+ * signal.
+ * <p>
+ * The property is read once, then each change is received through the
+ * subscription shared by the listeners of the property. {@link #get()}
+ * returns the current value without calling into the native layer nor the
+ * network, it suits polling loops.
+ *
+ * @param <T>
+ *            the type of the property
+ * @see AnyObject#mirrorProperty(String)
+ */
+public class PropertyMirror<T> implements Closeable {
+    private final QiSignalConnection connection;
+    private final Future<T> initialValue;
+    private volatile T value;
+    private volatile boolean hasValue;
+
+    @SuppressWarnings("unchecked")
+    PropertyMirror(AnyObject object, String property) {
+        // subscribe before reading, not to miss a change
+        this.connection = object.connect(property, new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                update((T) args[0], true);
+            }
+        });
+        this.initialValue = object.property(property);
+    }
+
+    private synchronized void update(T newValue, boolean changed) {
+        // a change received during the initial read is more recent
+        if (changed || !this.hasValue) {
+            this.value = newValue;
+            this.hasValue = true;
+        }
+    }
+
+    /**
+     * Get the current value of the property, waiting for the initial read if
+     * it is not finished.
+     *
+     * @return the current value
+     * @throws ExecutionException
+     *             if the initial read failed
+     */
+    public T get() throws ExecutionException {
+        if (!this.hasValue) {
+            this.update(this.initialValue.get(), false);
+        }
+
+        return this.value;
+    }
+
+    /**
+     * Tell whether the current value of the property is known, i.e. whether
+     * {@link #get()} returns immediately.
+     *
+     * @return {@code true} if the value is known
+     */
+    public boolean hasValue() {
+        return this.hasValue || this.initialValue.isDone();
+    }
+
+    /**
+     * Stop following the changes of the property.
+     */
+    @Override
+    public void close() {
+        this.connection.disconnect();
+    }
+}
@@ -0,0 +1,22 @@
+package com.aldebaran.qi;
+
+/**
+ * An implementation of this interface can be set as a callback to be invoked
+ * with the emissions of the specified signal, grouped in batches.
+ * <p>
+ * It suits high-rate signals: the emissions are queued by the native layer,
+ * which crosses JNI once per batch instead of once per emission.
+ *
+ * @see AnyObject#connect(String, QiSignalBatchListener, int, long, java.util.concurrent.TimeUnit)
+ */
+public interface QiSignalBatchListener {
+    /**
+     * Called with the emissions received since the previous call, oldest
+     * first.
+     *
+     * @param batch
+     *            the arguments of each emission, as they would be given to
+     *            {@link QiSignalListener#onSignalReceived(Object...)}
+     */
+    void onSignalsReceived(Object[][] batch);
+}
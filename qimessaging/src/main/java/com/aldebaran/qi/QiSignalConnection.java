@@ -5,6 +5,7 @@ import com.aldebaran.qi.serialization.QiSerializer;
 /**
  * Class that represents a connection to a signal. It is retrieved when calling
  * {@link AnyObject#connect(String, QiSignalListener)},
+ * {@link AnyObject#connect(String, QiSignalBatchListener, int, long, java.util.concurrent.TimeUnit)},
  * {@link AnyObject#connect(QiSerializer, String, Object, String)} or
  * {@link AnyObject#connect(String, Object, String)}.
  *
@@ -13,16 +14,39 @@ import com.aldebaran.qi.serialization.QiSerializer;
 public class QiSignalConnection {
     private AnyObject object;
     private Future<Long> future; // future of native SignalLink
+    private SignalQueue queue; // null if delivered without queue
+    // set if the native subscription is shared with other listeners
+    private String sharedSignalName;
+    private QiSignalListener sharedListener;
 
-    QiSignalConnection(AnyObject object, Future<Long> future) {
+    QiSignalConnection(AnyObject object, Future<Long> future, String sharedSignalName, QiSignalListener sharedListener) {
+        this(object, future, null);
+        this.sharedSignalName = sharedSignalName;
+        this.sharedListener = sharedListener;
+    }
+
+    QiSignalConnection(AnyObject object, Future<Long> future, SignalQueue queue) {
         this.object = object;
         this.future = future;
+        this.queue = queue;
     }
 
     public Future<Long> getFuture() {
         return future;
     }
 
+    SignalQueue getQueue() {
+        return queue;
+    }
+
+    String getSharedSignalName() {
+        return sharedSignalName;
+    }
+
+    QiSignalListener getSharedListener() {
+        return sharedListener;
+    }
+
     public Future<Void> disconnect() {
         return object.disconnect(this);
     }
@@ -30,4 +54,15 @@ public class QiSignalConnection {
     public void waitForDone() {
         future.sync();
     }
+
+    /**
+     * Number of emissions dropped by the {@link SignalDeliveryPolicy} of this
+     * connection because its listener did not keep up with them.
+     *
+     * @return the number of dropped emissions, always 0 for a connection
+     *         without policy
+     */
+    public long getDroppedCount() {
+        return queue == null ? 0 : queue.dropped();
+    }
 }
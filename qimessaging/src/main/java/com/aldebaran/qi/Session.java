@@ -5,7 +5,11 @@ package com.aldebaran.qi;
 
 import java.util.ArrayList;
 import java.util.Collections;
+import java.util.HashMap;
 import java.util.List;
+import java.util.Map;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
 
 /**
  * Class that allows using the messaging layer: it is responsible for connecting
@@ -37,14 +41,71 @@ public class Session {
         void onDisconnected(String reason);
     }
 
+    /**
+     * Notified by the native layer when a service is unregistered.
+     */
+    interface ServiceListener {
+        void onServiceUnregistered(String name);
+    }
+
+    /**
+     * Endpoint selected by {@link #connectFirst(String[], long, TimeUnit)},
+     * and the session connected to it.
+     */
+    public static class ConnectedEndpoint {
+        private final Session session;
+        private final String url;
+        private final long handshakeMicros;
+
+        ConnectedEndpoint(Session session, String url, long handshakeMicros) {
+            this.session = session;
+            this.url = url;
+            this.handshakeMicros = handshakeMicros;
+        }
+
+        /**
+         * @return the session connected to the endpoint
+         */
+        public Session getSession() {
+            return session;
+        }
+
+        /**
+         * @return the URL the session is connected to
+         */
+        public String getUrl() {
+            return url;
+        }
+
+        /**
+         * @param unit unit of the result
+         * @return the time the winning attempt took to connect
+         */
+        public long getHandshakeTime(TimeUnit unit) {
+            return unit.convert(handshakeMicros, TimeUnit.MICROSECONDS);
+        }
+
+        @Override
+        public String toString() {
+            return url + " (" + handshakeMicros + " us)";
+        }
+    }
+
+    /**
+     * Delay between the attempts of {@link #connectFirst(String[])}.
+     */
+    public static final long DEFAULT_CONNECT_STAGGER_MILLIS = 250;
+
     // Native function
     private native long qiSessionCreate();
 
-    private native void qiSessionDestroy(long pSession);
+    private static native void qiSessionDestroy(long pSession);
 
     private native long qiSessionConnect(long pSession, String url);
 
-    private native boolean qiSessionIsConnected(long pSession);
+    private static native long qiSessionConnectRace(String[] urls, long staggerMicros);
+
+    private static native boolean qiSessionIsConnected(long pSession);
 
     private native void qiSessionClose(long pSession);
 
@@ -58,6 +119,8 @@ public class Session {
 
     private native void addConnectionListener(long pSession, ConnectionListener listener);
 
+    private native void addServiceListener(long pSession, ServiceListener listener);
+
     private native void setClientAuthenticatorFactory(long pSession, ClientAuthenticatorFactory factory);
 
     private native void loadService(long pSession, String name);
@@ -76,6 +139,10 @@ public class Session {
 
     private List<ConnectionListener> listeners;
 
+    // Lookups of the services, shared by all the callers
+    private final Map<String, Future<AnyObject>> services = new HashMap<String, Future<AnyObject>>();
+    private boolean servicesInvalidated;
+
     /**
      * Create a qimessaging session.
      */
@@ -89,6 +156,11 @@ public class Session {
         _destroy = false;
     }
 
+    private Session(long session, boolean destroy) {
+        _session = session;
+        _destroy = destroy;
+    }
+
     /**
      * @return true is session is connected, false otherwise
      */
@@ -110,15 +182,190 @@ public class Session {
         return new Future<Void>(pFuture);
     }
 
+    /**
+     * Try to connect to given address, then prefetch the given services.
+     *
+     * @param serviceDirectoryAddress Address to connect to.
+     * @param services Names of the services to prefetch once connected.
+     * @return a future finished once connected and all the services are
+     * looked up
+     * @see #prefetchServices(String...)
+     */
+    public Future<Void> connect(String serviceDirectoryAddress, final String... services) {
+        return connect(serviceDirectoryAddress).andThenCompose(new Function<Void, Future<Void>>() {
+            @Override
+            public Future<Void> execute(Void value) {
+                return prefetchServices(services);
+            }
+        });
+    }
+
+    /**
+     * Connect a new session to the first of the given addresses that answers,
+     * waiting {@link #DEFAULT_CONNECT_STAGGER_MILLIS} between the attempts.
+     *
+     * @param serviceDirectoryAddresses Addresses to connect to, by preference.
+     * @return a future to the endpoint the session is connected to
+     * @see #connectFirst(String[], long, TimeUnit)
+     */
+    public static Future<ConnectedEndpoint> connectFirst(String[] serviceDirectoryAddresses) {
+        return connectFirst(serviceDirectoryAddresses, DEFAULT_CONNECT_STAGGER_MILLIS, TimeUnit.MILLISECONDS);
+    }
+
+    /**
+     * Connect a new session to the first of the given addresses that answers.
+     * <p>
+     * The first address is tried at once, each next one after the given
+     * delay, without waiting for the previous attempts to fail: an endpoint
+     * that does not answer costs the delay, not a full connection timeout.
+     * Each attempt is made by a session of its own, since a session connects
+     * only once: the first to succeed is the resulting session, the others
+     * are closed. The future fails only if all of them fail. Cancelling it
+     * stops the race and closes the sessions of the pending attempts.
+     *
+     * @param serviceDirectoryAddresses Addresses to connect to, by preference.
+     * @param stagger Delay between the start of two attempts.
+     * @param unit Unit of the delay.
+     * @return a future to the endpoint, holding the session connected to it
+     */
+    public static Future<ConnectedEndpoint> connectFirst(String[] serviceDirectoryAddresses, long stagger,
+            TimeUnit unit) {
+        long pFuture = qiSessionConnectRace(serviceDirectoryAddresses, unit.toMicros(stagger));
+        return new Future<List<Object>>(pFuture).andThenApply(new Function<List<Object>, ConnectedEndpoint>() {
+            @Override
+            public ConnectedEndpoint execute(List<Object> endpoint) {
+                Session session = new Session(((Number) endpoint.get(2)).longValue(), true);
+                return new ConnectedEndpoint(session, (String) endpoint.get(0), ((Number) endpoint.get(1)).longValue());
+            }
+        }, FutureCallbackType.Sync);
+    }
+
+    /**
+     * Look up many services concurrently, and cache them for
+     * {@link #service(String)}.
+     * <p>
+     * All the lookups are launched at once, each one connecting to the
+     * endpoint of its service, instead of waiting for each other.
+     *
+     * @param names Names of the services.
+     * @return a future finished once all the services are looked up, or as
+     * soon as one of the lookups fails
+     */
+    public Future<Void> prefetchServices(String... names) {
+        Future<?>[] futures = new Future<?>[names.length];
+        for (int i = 0; i < names.length; ++i) {
+            futures[i] = service(names[i]);
+        }
+        return Future.waitAll(futures);
+    }
+
     /**
      * Ask for remote service to Service Directory.
+     * <p>
+     * The lookups are cached: the callers asking for the same service get the
+     * same {@link AnyObject}, until the service is unregistered or the
+     * session is disconnected. Concurrent lookups of a service not cached yet
+     * share a single request. A failed lookup is not cached.
+     * <p>
+     * Each call returns its own future: cancelling it gives up this call
+     * only, the shared request goes on for the other callers.
      *
      * @param name Name of service.
      * @return the AnyObject future
      */
     public Future<AnyObject> service(String name) {
-        long pFuture = service(_session, name);
-        return new Future<AnyObject>(pFuture);
+        final Future<AnyObject> lookup = sharedLookup(name);
+
+        if (lookup.isDone() && lookup.isSuccess()) {
+            return Future.of(lookup.getValue());
+        }
+
+        final Promise<AnyObject> promise = new Promise<AnyObject>();
+        // set once, by the lookup or by a cancellation of this caller
+        final AtomicBoolean settled = new AtomicBoolean();
+        promise.setOnCancel(new Promise.CancelRequestCallback<AnyObject>() {
+            @Override
+            public void onCancelRequested(Promise<AnyObject> promise) {
+                if (settled.compareAndSet(false, true)) {
+                    promise.setCancelled();
+                }
+            }
+        });
+        lookup.thenConsume(new Consumer<Future<AnyObject>>() {
+            @Override
+            public void consume(Future<AnyObject> future) {
+                if (!settled.compareAndSet(false, true)) {
+                    return;
+                }
+
+                if (future.isCancelled()) {
+                    promise.setCancelled();
+                }
+                else if (future.hasError()) {
+                    promise.setError(future.getErrorMessage());
+                }
+                else {
+                    promise.setValue(future.getValue());
+                }
+            }
+        });
+        return promise.getFuture();
+    }
+
+    /**
+     * Get the lookup of a service shared by all the callers, looking it up if
+     * it is not cached. It is never given to the callers, so that none of
+     * them can cancel it.
+     */
+    private Future<AnyObject> sharedLookup(String name) {
+        initializeServiceInvalidation();
+
+        synchronized (services) {
+            Future<AnyObject> future = services.get(name);
+
+            if (future == null || (future.isDone() && !future.isSuccess())) {
+                future = new Future<AnyObject>(service(_session, name));
+                services.put(name, future);
+            }
+
+            return future;
+        }
+    }
+
+    private void invalidateService(String name) {
+        synchronized (services) {
+            services.remove(name);
+        }
+    }
+
+    private void invalidateServices() {
+        synchronized (services) {
+            services.clear();
+        }
+    }
+
+    private synchronized void initializeServiceInvalidation() {
+        if (servicesInvalidated)
+            return;
+
+        servicesInvalidated = true;
+        addServiceListener(_session, new ServiceListener() {
+            @Override
+            public void onServiceUnregistered(String name) {
+                invalidateService(name);
+            }
+        });
+        addConnectionListener(new ConnectionListener() {
+            @Override
+            public void onConnected() {
+                // nothing cached yet
+            }
+
+            @Override
+            public void onDisconnected(String reason) {
+                invalidateServices();
+            }
+        });
     }
 
     /**
@@ -0,0 +1,60 @@
+package com.aldebaran.qi;
+
+/**
+ * Policy applied by the native layer to the emissions of a signal waiting for
+ * a listener that does not keep up with them.
+ *
+ * @see AnyObject#connect(String, QiSignalListener, SignalDeliveryPolicy)
+ * @see QiSignalConnection#getDroppedCount()
+ */
+public final class SignalDeliveryPolicy {
+    private static final SignalDeliveryPolicy UNBOUNDED = new SignalDeliveryPolicy(0);
+    private static final SignalDeliveryPolicy CONFLATE = new SignalDeliveryPolicy(1);
+
+    // maximum number of pending emissions, 0 for no limit
+    private final int capacity;
+
+    private SignalDeliveryPolicy(int capacity) {
+        this.capacity = capacity;
+    }
+
+    /**
+     * Keep every emission until it is delivered, whatever the memory it
+     * takes.
+     *
+     * @return the policy
+     */
+    public static SignalDeliveryPolicy unbounded() {
+        return UNBOUNDED;
+    }
+
+    /**
+     * Keep at most {@code capacity} pending emissions, dropping the oldest
+     * ones to make room for the new ones.
+     *
+     * @param capacity
+     *            the maximum number of pending emissions
+     * @return the policy
+     */
+    public static SignalDeliveryPolicy dropOldest(int capacity) {
+        if (capacity <= 0) {
+            throw new IllegalArgumentException("capacity must be positive");
+        }
+
+        return new SignalDeliveryPolicy(capacity);
+    }
+
+    /**
+     * Keep only the latest pending emission, the listener always receives
+     * the most recent value.
+     *
+     * @return the policy
+     */
+    public static SignalDeliveryPolicy conflate() {
+        return CONFLATE;
+    }
+
+    int capacity() {
+        return capacity;
+    }
+}
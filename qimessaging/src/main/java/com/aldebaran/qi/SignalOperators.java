@@ -0,0 +1,152 @@
+package com.aldebaran.qi;
+
+import java.util.Arrays;
+
+/**
+ * Operators applied by the native layer to the emissions of a signal, before
+ * they are converted to Java objects: only the reduced stream of emissions
+ * reaches the listener.
+ * <p>
+ * The operators are applied in the order they are added. This class is
+ * immutable, each method returns a new instance:
+ *
+ * <pre>
+ * SignalOperators operators = new SignalOperators().windowMean(10).decimate(10);
+ * </pre>
+ *
+ * @see AnyObject#connect(String, QiSignalListener, SignalOperators,
+ *      SignalDeliveryPolicy)
+ */
+public final class SignalOperators {
+    // Must match the native SignalOperatorKind
+    private static final int DECIMATE = 0;
+    private static final int RATE_LIMIT = 1;
+    private static final int WINDOW_MEAN = 2;
+    private static final int WINDOW_MIN = 3;
+    private static final int WINDOW_MAX = 4;
+    private static final int DEADBAND = 5;
+
+    static final SignalOperators NONE = new SignalOperators();
+
+    private final int[] kinds;
+    private final double[] parameters;
+
+    /**
+     * Create an empty list of operators, letting every emission through.
+     */
+    public SignalOperators() {
+        this(new int[0], new double[0]);
+    }
+
+    private SignalOperators(int[] kinds, double[] parameters) {
+        this.kinds = kinds;
+        this.parameters = parameters;
+    }
+
+    private SignalOperators then(int kind, double parameter) {
+        int[] newKinds = Arrays.copyOf(kinds, kinds.length + 1);
+        double[] newParameters = Arrays.copyOf(parameters, parameters.length + 1);
+        newKinds[kinds.length] = kind;
+        newParameters[parameters.length] = parameter;
+        return new SignalOperators(newKinds, newParameters);
+    }
+
+    private static void checkSize(int size, String what) {
+        if (size < 1) {
+            throw new IllegalArgumentException(what + " must be at least 1");
+        }
+    }
+
+    /**
+     * Let one emission out of {@code factor} through, starting with the
+     * first one.
+     *
+     * @param factor
+     *            the decimation factor
+     * @return the operators followed by this one
+     */
+    public SignalOperators decimate(int factor) {
+        checkSize(factor, "factor");
+        return then(DECIMATE, factor);
+    }
+
+    /**
+     * Drop the emissions following the previous one let through by less
+     * than {@code 1 / maxFrequency} seconds.
+     *
+     * @param maxFrequency
+     *            the maximum number of emissions per second
+     * @return the operators followed by this one
+     */
+    public SignalOperators rateLimit(double maxFrequency) {
+        if (!(maxFrequency > 0)) {
+            throw new IllegalArgumentException("maxFrequency must be positive");
+        }
+
+        return then(RATE_LIMIT, maxFrequency);
+    }
+
+    /**
+     * Replace each numeric argument by the mean of its last {@code size}
+     * values, as a {@link Double}.
+     *
+     * @param size
+     *            the number of values in the window
+     * @return the operators followed by this one
+     */
+    public SignalOperators windowMean(int size) {
+        checkSize(size, "size");
+        return then(WINDOW_MEAN, size);
+    }
+
+    /**
+     * Replace each numeric argument by the minimum of its last {@code size}
+     * values, as a {@link Double}.
+     *
+     * @param size
+     *            the number of values in the window
+     * @return the operators followed by this one
+     */
+    public SignalOperators windowMin(int size) {
+        checkSize(size, "size");
+        return then(WINDOW_MIN, size);
+    }
+
+    /**
+     * Replace each numeric argument by the maximum of its last {@code size}
+     * values, as a {@link Double}.
+     *
+     * @param size
+     *            the number of values in the window
+     * @return the operators followed by this one
+     */
+    public SignalOperators windowMax(int size) {
+        checkSize(size, "size");
+        return then(WINDOW_MAX, size);
+    }
+
+    /**
+     * Drop the emissions whose numeric arguments all differ by at most
+     * {@code threshold} from the previous emission let through. Emissions
+     * without numeric argument are always let through.
+     *
+     * @param threshold
+     *            the largest change ignored
+     * @return the operators followed by this one
+     */
+    public SignalOperators deadband(double threshold) {
+        if (!(threshold >= 0)) {
+            throw new IllegalArgumentException("threshold must not be negative");
+        }
+
+        return then(DEADBAND, threshold);
+    }
+
+    int[] kinds() {
+        return kinds;
+    }
+
+    double[] parameters() {
+        return parameters;
+    }
+}
@@ -0,0 +1,63 @@
+package com.aldebaran.qi;
+
+/**
+ * Native queue delivering the emissions of a signal to a
+ * {@link QiSignalBatchListener}.
+ * <p>
+ * The queue stays alive as long as the signal delivers to it, this object
+ * only gives access to its counters.
+ */
+class SignalQueue {
+
+    // Loading QiMessaging JNI layer
+    static {
+        if (!EmbeddedTools.LOADED_EMBEDDED_LIBRARY) {
+            EmbeddedTools loader = new EmbeddedTools();
+            loader.loadEmbeddedLibraries();
+        }
+    }
+
+    // C++ signal queue
+    private final long queuePtr;
+
+    private native long qiSignalQueueCreate(QiSignalBatchListener listener, int maxBatchSize, long maxLatencyMicros,
+            int capacity, int[] operatorKinds, double[] operatorParameters);
+
+    private native long qiSignalQueueDropped(long pQueue);
+
+    private native void qiSignalQueueClose(long pQueue);
+
+    private native void qiSignalQueueDestroy(long pQueue);
+
+    SignalQueue(QiSignalBatchListener listener, int maxBatchSize, long maxLatencyMicros, SignalOperators operators,
+            SignalDeliveryPolicy policy) {
+        this.queuePtr = this.qiSignalQueueCreate(listener, maxBatchSize, maxLatencyMicros, policy.capacity(),
+                operators.kinds(), operators.parameters());
+    }
+
+    long pointer() {
+        return this.queuePtr;
+    }
+
+    long dropped() {
+        return this.qiSignalQueueDropped(this.queuePtr);
+    }
+
+    /**
+     * Drop the pending emissions and stop delivering them. Once it returns,
+     * the listener is not called any more, unless it is the caller.
+     */
+    void close() {
+        this.qiSignalQueueClose(this.queuePtr);
+    }
+
+    /**
+     * Called by garbage collector Finalize is overriden to manually delete C++
+     * data
+     */
+    @Override
+    protected void finalize() throws Throwable {
+        this.qiSignalQueueDestroy(this.queuePtr);
+        super.finalize();
+    }
+}
@@ -4,8 +4,12 @@
 */
 package com.aldebaran.qi;
 
+import java.util.concurrent.CancellationException;
+import java.util.concurrent.TimeUnit;
+
 import org.junit.Test;
 
+import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertTrue;
 import static org.junit.Assert.fail;
 
@@ -61,6 +65,51 @@ public class ClientTest {
         s.close();
     }
 
+    /**
+     * Connect to the first endpoint that answers, an unreachable one first.
+     */
+    @Test
+    public void testConnectRace() throws Exception {
+        ServiceDirectory sd = new ServiceDirectory();
+        String url = sd.listenUrl();
+
+        // nothing listens on the discard port
+        String[] urls = new String[] { "tcp://127.0.0.1:9", url };
+        Session.ConnectedEndpoint endpoint = Session.connectFirst(urls, 50, TimeUnit.MILLISECONDS).get(10,
+                TimeUnit.SECONDS);
+
+        assertEquals(url, endpoint.getUrl());
+        assertTrue(endpoint.getHandshakeTime(TimeUnit.MICROSECONDS) >= 0);
+        Session session = endpoint.getSession();
+        assertTrue("Session must be connected to the winning endpoint", session.isConnected());
+        session.close();
+        sd.close();
+    }
+
+    /**
+     * Cancel the race while the next attempt waits for its turn.
+     */
+    @Test
+    public void testConnectRaceCancel() throws Exception {
+        ServiceDirectory sd = new ServiceDirectory();
+        String url = sd.listenUrl();
+
+        // the reachable endpoint is tried only after the stagger delay
+        String[] urls = new String[] { "tcp://127.0.0.1:9", url };
+        Future<Session.ConnectedEndpoint> race = Session.connectFirst(urls, 1, TimeUnit.SECONDS);
+        Thread.sleep(100);
+        race.requestCancellation();
+
+        try {
+            race.get(3, TimeUnit.SECONDS);
+            fail("The race must be cancelled, not won");
+        }
+        catch (CancellationException e) {
+            assertTrue(race.isCancelled());
+        }
+        sd.close();
+    }
+
     /**
      * Test Session constructor
      */
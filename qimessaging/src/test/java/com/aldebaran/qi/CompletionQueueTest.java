@@ -0,0 +1,95 @@
+package com.aldebaran.qi;
+
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicReference;
+
+import org.junit.Assert;
+import org.junit.Test;
+
+public class CompletionQueueTest {
+    @Test
+    public void testDrain() {
+        CompletionQueue queue = new CompletionQueue();
+        Promise<Integer> valuePromise = new Promise<Integer>();
+        Promise<Integer> errorPromise = new Promise<Integer>();
+        Promise<Integer> cancelledPromise = new Promise<Integer>();
+        queue.register(valuePromise.getFuture(), 1);
+        queue.register(errorPromise.getFuture(), 2);
+        queue.register(cancelledPromise.getFuture(), 3);
+
+        valuePromise.setValue(42);
+        errorPromise.setError("something went wrong");
+        cancelledPromise.setCancelled();
+
+        long[] tags = new long[8];
+        int[] states = new int[8];
+        Object[] results = new Object[8];
+        Assert.assertEquals(3, queue.drain(tags, states, results, 1, TimeUnit.SECONDS));
+
+        Assert.assertEquals(1, tags[0]);
+        Assert.assertEquals(CompletionQueue.VALUE, states[0]);
+        Assert.assertEquals(42, results[0]);
+        Assert.assertEquals(2, tags[1]);
+        Assert.assertEquals(CompletionQueue.ERROR, states[1]);
+        Assert.assertEquals("something went wrong", results[1]);
+        Assert.assertEquals(3, tags[2]);
+        Assert.assertEquals(CompletionQueue.CANCELLED, states[2]);
+        Assert.assertNull(results[2]);
+
+        Assert.assertEquals(0, queue.drain(tags, states, results, 0, TimeUnit.SECONDS));
+        queue.close();
+    }
+
+    @Test
+    public void testDrainWaits() {
+        CompletionQueue queue = new CompletionQueue();
+        final Promise<Integer> promise = new Promise<Integer>();
+        queue.register(promise.getFuture(), 7);
+        new Thread(new Runnable() {
+
+            @Override
+            public void run() {
+                try {
+                    Thread.sleep(50);
+                    promise.setValue(42);
+                }
+                catch (InterruptedException e) {
+                    // ignore
+                }
+            }
+        }).start();
+
+        long[] tags = new long[1];
+        int[] states = new int[1];
+        Object[] results = new Object[1];
+        Assert.assertEquals(1, queue.drain(tags, states, results));
+        Assert.assertEquals(7, tags[0]);
+        queue.close();
+    }
+
+    @Test
+    public void testCloseWakesDrain() throws InterruptedException {
+        final CompletionQueue queue = new CompletionQueue();
+        final AtomicReference<Throwable> failure = new AtomicReference<Throwable>();
+        Thread drainer = new Thread(new Runnable() {
+
+            @Override
+            public void run() {
+                try {
+                    queue.drain(new long[1], new int[1], new Object[1]);
+                }
+                catch (Throwable e) {
+                    failure.set(e);
+                }
+            }
+        });
+        drainer.start();
+        // let the drainer wait for completions
+        Thread.sleep(100);
+        queue.close();
+        drainer.join(1000);
+
+        Assert.assertFalse(drainer.isAlive());
+        Assert.assertTrue(failure.get() instanceof IllegalStateException);
+    }
+}
@@ -46,6 +46,8 @@ public class EventTest {
 
         // Register event 'Fire'
         ob.advertiseSignal("fire::(i)");
+        ob.advertiseSignal("fireDouble::(d)");
+        ob.advertiseSignal("fireString::(s)");
         ob.advertiseSignal("bigFire::([({s((s(is))[(s(is))])})])");
         ob.advertiseMethod("reply::s(s)", reply, "Concatenate given argument with 'bim !'");
         ob.advertiseMethod("answer::s()", reply, "Return given argument");
@@ -152,6 +154,281 @@ public class EventTest {
         assertEquals(99, value.get());
     }
 
+    @Test
+    public void testSharedSignal() throws InterruptedException {
+        final Object[][] received = new Object[2][];
+        QiSignalConnection first = proxy.connect("fire", new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                received[0] = args;
+            }
+        });
+        QiSignalConnection second = proxy.connect("fire", new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                received[1] = args;
+            }
+        });
+        // a single native subscription
+        assertSame(first.getFuture(), second.getFuture());
+        second.waitForDone();
+        obj.post("fire", 42);
+        Thread.sleep(100);
+        assertEquals(42, received[0][0]);
+        // converted once
+        assertSame(received[0], received[1]);
+
+        first.disconnect().sync();
+        received[1] = null;
+        obj.post("fire", 99);
+        Thread.sleep(100);
+        assertEquals(99, received[1][0]);
+        assertEquals(42, received[0][0]);
+
+        second.disconnect().sync();
+        received[1] = null;
+        obj.post("fire", 12);
+        Thread.sleep(100);
+        assertNull(received[1]);
+    }
+
+    @Test
+    public void testLastValueCache() throws InterruptedException {
+        proxy.enableLastValueCache("fire", 1, TimeUnit.MINUTES);
+        Thread.sleep(100); // Give time for the subscription to be done.
+        obj.post("fire", 42);
+        Thread.sleep(100);
+
+        final AtomicInteger value = new AtomicInteger();
+        QiSignalConnection connection = proxy.connect("fire", new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                value.set((Integer) args[0]);
+            }
+        });
+        // delivered on subscribe
+        assertEquals(42, value.get());
+
+        connection.disconnect().sync();
+        proxy.disableLastValueCache("fire").sync();
+    }
+
+    @Test
+    public void testBatchedSignal() throws InterruptedException {
+        final List<Integer> values = new ArrayList<Integer>();
+        final AtomicInteger batches = new AtomicInteger();
+        QiSignalConnection connection = proxy.connect("fire", new QiSignalBatchListener() {
+            @Override
+            public void onSignalsReceived(Object[][] batch) {
+                batches.incrementAndGet();
+                synchronized (values) {
+                    for (Object[] args : batch) {
+                        values.add((Integer) args[0]);
+                    }
+                }
+            }
+        }, 10, 50, TimeUnit.MILLISECONDS);
+        connection.waitForDone();
+        for (int i = 0; i < 25; ++i) {
+            obj.post("fire", i);
+        }
+        Thread.sleep(200);
+        synchronized (values) {
+            assertEquals(25, values.size());
+            for (int i = 0; i < 25; ++i) {
+                assertEquals(i, (int) values.get(i));
+            }
+        }
+        // 2 full batches, the remaining emissions after the latency
+        assertTrue(batches.get() >= 3 && batches.get() < 25);
+        connection.disconnect().sync();
+    }
+
+    @Test
+    public void testBatchedSignalDisconnectDropsPending() throws InterruptedException {
+        final AtomicInteger received = new AtomicInteger();
+        QiSignalConnection connection = proxy.connect("fire", new QiSignalBatchListener() {
+            @Override
+            public void onSignalsReceived(Object[][] batch) {
+                received.addAndGet(batch.length);
+            }
+        }, 10, 300, TimeUnit.MILLISECONDS);
+        connection.waitForDone();
+        for (int i = 0; i < 3; ++i) {
+            obj.post("fire", i);
+        }
+        Thread.sleep(50); // Give time for the emissions to be queued.
+        connection.disconnect().sync();
+        int receivedOnDisconnect = received.get();
+
+        // past the latency of the pending batch
+        Thread.sleep(500);
+        assertEquals(0, receivedOnDisconnect);
+        assertEquals("listener called after disconnect", 0, received.get());
+    }
+
+    @Test
+    public void testSignalConflated() throws InterruptedException {
+        final List<Integer> values = new ArrayList<Integer>();
+        QiSignalConnection connection = proxy.connect("fire", new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                synchronized (values) {
+                    values.add((Integer) args[0]);
+                }
+                try {
+                    Thread.sleep(20); // slow listener
+                }
+                catch (InterruptedException e) {
+                    // ignore
+                }
+            }
+        }, SignalDeliveryPolicy.conflate());
+        connection.waitForDone();
+        for (int i = 0; i < 20; ++i) {
+            obj.post("fire", i);
+        }
+        Thread.sleep(300);
+        synchronized (values) {
+            assertTrue(values.size() < 20);
+            assertEquals(19, (int) values.get(values.size() - 1));
+            assertEquals(20 - values.size(), connection.getDroppedCount());
+        }
+        connection.disconnect().sync();
+    }
+
+    @Test
+    public void testSignalOperators() throws InterruptedException {
+        final List<Object> values = new ArrayList<Object>();
+        SignalOperators operators = new SignalOperators().windowMean(4).decimate(4);
+        QiSignalConnection connection = proxy.connect("fire", new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                synchronized (values) {
+                    values.add(args[0]);
+                }
+            }
+        }, operators, SignalDeliveryPolicy.unbounded());
+        connection.waitForDone();
+        for (int i = 0; i < 8; ++i) {
+            obj.post("fire", i);
+        }
+        Thread.sleep(100);
+        synchronized (values) {
+            assertEquals(2, values.size());
+            assertEquals(0.0, (Double) values.get(0), 0);
+            // mean of 1, 2, 3, 4
+            assertEquals(2.5, (Double) values.get(1), 0);
+        }
+        connection.disconnect().sync();
+    }
+
+    /**
+     * Connect a listener adding the first argument of each emission to
+     * {@code values}.
+     */
+    private QiSignalConnection connectCollecting(String signalName, SignalOperators operators,
+            final List<Object> values) {
+        QiSignalConnection connection = proxy.connect(signalName, new QiSignalListener() {
+            @Override
+            public void onSignalReceived(Object... args) {
+                synchronized (values) {
+                    values.add(args[0]);
+                }
+            }
+        }, operators, SignalDeliveryPolicy.unbounded());
+        connection.waitForDone();
+        return connection;
+    }
+
+    @Test
+    public void testSignalRateLimit() throws InterruptedException {
+        final List<Object> values = new ArrayList<Object>();
+        QiSignalConnection connection = connectCollecting("fire", new SignalOperators().rateLimit(5), values);
+        for (int i = 0; i < 10; ++i) {
+            obj.post("fire", i);
+        }
+        Thread.sleep(300);
+        obj.post("fire", 99);
+        Thread.sleep(100);
+        synchronized (values) {
+            // the burst is limited to its first emission
+            assertEquals(2, values.size());
+            assertEquals(0, values.get(0));
+            assertEquals(99, values.get(1));
+        }
+        connection.disconnect().sync();
+    }
+
+    @Test
+    public void testSignalWindowMinMax() throws InterruptedException {
+        final List<Object> mins = new ArrayList<Object>();
+        final List<Object> maxs = new ArrayList<Object>();
+        QiSignalConnection minConnection = connectCollecting("fire", new SignalOperators().windowMin(3), mins);
+        QiSignalConnection maxConnection = connectCollecting("fire", new SignalOperators().windowMax(3), maxs);
+        int[] posted = { 5, 1, 4, 8, 2, 7 };
+        for (int value : posted) {
+            obj.post("fire", value);
+        }
+        Thread.sleep(100);
+        double[] expectedMins = { 5, 1, 1, 1, 2, 2 };
+        double[] expectedMaxs = { 5, 5, 5, 8, 8, 8 };
+        synchronized (mins) {
+            assertEquals(posted.length, mins.size());
+            for (int i = 0; i < posted.length; ++i) {
+                assertEquals(expectedMins[i], (Double) mins.get(i), 0);
+            }
+        }
+        synchronized (maxs) {
+            assertEquals(posted.length, maxs.size());
+            for (int i = 0; i < posted.length; ++i) {
+                assertEquals(expectedMaxs[i], (Double) maxs.get(i), 0);
+            }
+        }
+        minConnection.disconnect().sync();
+        maxConnection.disconnect().sync();
+    }
+
+    @Test
+    public void testSignalDeadband() throws InterruptedException {
+        final List<Object> values = new ArrayList<Object>();
+        QiSignalConnection connection = connectCollecting("fireDouble", new SignalOperators().deadband(1), values);
+        double[] posted = { 0, 0.5, 1.5, 1.9, Double.NaN, Double.NaN, 3 };
+        for (double value : posted) {
+            obj.post("fireDouble", value);
+        }
+        Thread.sleep(100);
+        synchronized (values) {
+            assertEquals(4, values.size());
+            assertEquals(0, (Double) values.get(0), 0);
+            assertEquals(1.5, (Double) values.get(1), 0);
+            // becoming NaN is a change, staying NaN is not
+            assertTrue(Double.isNaN((Double) values.get(2)));
+            assertEquals(3, (Double) values.get(3), 0);
+        }
+        connection.disconnect().sync();
+    }
+
+    @Test
+    public void testSignalDeadbandNonNumeric() throws InterruptedException {
+        final List<Object> values = new ArrayList<Object>();
+        QiSignalConnection connection = connectCollecting("fireString", new SignalOperators().deadband(1), values);
+        obj.post("fireString", "a");
+        obj.post("fireString", "a");
+        obj.post("fireString", "b");
+        Thread.sleep(100);
+        synchronized (values) {
+            // nothing to compare, all let through
+            assertEquals(3, values.size());
+        }
+        connection.disconnect().sync();
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void testSignalDeadbandNaNThreshold() {
+        new SignalOperators().deadband(Double.NaN);
+    }
+
     @Test
     public void testSignalSlot() throws InterruptedException {
         final AtomicBoolean correct = new AtomicBoolean();
@@ -169,6 +446,33 @@ public class EventTest {
         connection.disconnect();
     }
 
+    @Test
+    public void testSignalPrimitiveSlot() throws InterruptedException {
+        final AtomicInteger value = new AtomicInteger();
+        Object callback = new Object() {
+            @QiSlot
+            public void onFire(int i) {
+                value.set(i);
+            }
+        };
+        QiSignalConnection connection = proxy.connectPrimitive("fire", callback, "onFire");
+        connection.waitForDone();
+        obj.post("fire", 42);
+        Thread.sleep(100);
+        assertEquals(42, value.get());
+        connection.disconnect().sync();
+    }
+
+    @Test(expected = QiSlotException.class)
+    public void testSignalPrimitiveSlotMismatch() {
+        Object callback = new Object() {
+            @QiSlot
+            public void onFire(float f) {
+            }
+        };
+        proxy.connectPrimitive("fire", callback, "onFire");
+    }
+
     @Test(expected = QiSlotException.class)
     public void testSignalAmbiguousSlot() {
         Object callback = new Object() {
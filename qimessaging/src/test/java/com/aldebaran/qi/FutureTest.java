@@ -10,6 +10,7 @@ import static org.junit.Assert.assertNull;
 import static org.junit.Assert.assertTrue;
 import static org.junit.Assert.fail;
 
+import java.util.List;
 import java.util.concurrent.CancellationException;
 import java.util.concurrent.CountDownLatch;
 import java.util.concurrent.ExecutionException;
@@ -21,6 +22,7 @@ import java.util.concurrent.atomic.AtomicLong;
 import junit.framework.Assert;
 
 import org.junit.After;
+import org.junit.Assume;
 import org.junit.Before;
 import org.junit.Test;
 
@@ -70,6 +72,7 @@ public class FutureTest {
         ob.advertiseMethod("throwUp::v()", reply, "Throws");
         ob.advertiseMethod("getFuture::s(s)", reply, "Returns a future");
         ob.advertiseMethod("getCancellableFuture::s(s)", reply, "Returns a cancellable future");
+        ob.advertiseMethod("getFutureThrowing::s()", reply, "Throws instead of returning a future");
 
         // Connect session to Service Directory
         s.connect(url).sync();
@@ -758,6 +761,382 @@ public class FutureTest {
         Future.waitAll().get(1, TimeUnit.SECONDS);
     }
 
+    @Test
+    public void testAllOf() throws ExecutionException, TimeoutException {
+        Promise<Long> p1 = new Promise<Long>();
+        Promise<Long> p2 = new Promise<Long>();
+        new Thread(new AsyncWait(p1, 100, AsyncWait.Type.VALUE)).start();
+        new Thread(new AsyncWait(p2, 50, AsyncWait.Type.VALUE)).start();
+        List<Long> values = Future.allOf(p1.getFuture(), p2.getFuture()).get(1, TimeUnit.SECONDS);
+        assertEquals(2, values.size());
+        assertEquals(100, (long) values.get(0));
+        assertEquals(50, (long) values.get(1));
+    }
+
+    @Test
+    public void testAnyOf() throws ExecutionException, TimeoutException {
+        Promise<Long> p1 = new Promise<Long>();
+        Promise<Long> p2 = new Promise<Long>();
+        new Thread(new AsyncWait(p1, 500, AsyncWait.Type.VALUE)).start();
+        new Thread(new AsyncWait(p2, 50, AsyncWait.Type.VALUE)).start();
+        long value = Future.anyOf(p1.getFuture(), p2.getFuture()).get(1, TimeUnit.SECONDS);
+        assertEquals(50, value);
+    }
+
+    @Test(expected = ExecutionException.class)
+    public void testWaitAnyWithError() throws ExecutionException, TimeoutException {
+        Promise<Long> p1 = new Promise<Long>();
+        Promise<Long> p2 = new Promise<Long>();
+        new Thread(new AsyncWait(p1, 50, AsyncWait.Type.ERROR)).start();
+        new Thread(new AsyncWait(p2, 500, AsyncWait.Type.VALUE)).start();
+        Future.waitAny(p1.getFuture(), p2.getFuture()).get(1, TimeUnit.SECONDS);
+    }
+
+    @Test
+    public void testWithTimeoutExpired() throws InterruptedException {
+        Promise<Long> promise = new Promise<Long>();
+        Future<Long> future = promise.getFuture().withTimeout(50, TimeUnit.MILLISECONDS);
+        Thread.sleep(500);
+        // finished by the deadline itself, not by a timeout of the caller
+        assertTrue(future.isDone());
+        try {
+            future.get();
+            fail("get() must throw once the deadline expired");
+        }
+        catch (ExecutionException e) {
+            assertTrue(e.getCause() instanceof TimeoutException);
+        }
+    }
+
+    @Test
+    public void testWithTimeoutErrorIsNotExpiry() throws TimeoutException {
+        Promise<Long> promise = new Promise<Long>();
+        Future<Long> future = promise.getFuture().withTimeout(1, TimeUnit.SECONDS);
+        // the message of an expired deadline, but a genuine error
+        promise.setError("Future deadline expired");
+        try {
+            future.get(2, TimeUnit.SECONDS);
+            fail("get() must throw the error");
+        }
+        catch (ExecutionException e) {
+            assertEquals("Future deadline expired", e.getCause().getMessage());
+        }
+    }
+
+    @Test
+    public void testWithTimeoutInTime() throws ExecutionException, TimeoutException {
+        Promise<Long> promise = new Promise<Long>();
+        new Thread(new AsyncWait(promise, 50, AsyncWait.Type.VALUE)).start();
+        long value = promise.getFuture().withTimeout(1, TimeUnit.SECONDS).get(2, TimeUnit.SECONDS);
+        assertEquals(50, value);
+    }
+
+    /**
+     * CompletableFuture is only reachable reflectively, the library targets Java 6.
+     *
+     * @return a new CompletableFuture, or null if this JVM has none
+     */
+    private static Object newCompletableFuture() {
+        try {
+            return Class.forName("java.util.concurrent.CompletableFuture").newInstance();
+        }
+        catch (ClassNotFoundException e) {
+            return null;
+        }
+        catch (Exception e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    private static Object invoke(Object target, String name, Class<?>[] types, Object... args) throws Throwable {
+        try {
+            return target.getClass().getMethod(name, types).invoke(target, args);
+        }
+        catch (java.lang.reflect.InvocationTargetException e) {
+            throw e.getCause();
+        }
+    }
+
+    /** Get the outcome of a CompletableFuture, waiting at most one second. */
+    private static Object completableGet(Object completableFuture) throws Throwable {
+        return invoke(completableFuture, "get", new Class<?>[] { long.class, TimeUnit.class }, 1L, TimeUnit.SECONDS);
+    }
+
+    @Test
+    public void testCompleteIntoValue() throws Throwable {
+        Object completableFuture = newCompletableFuture();
+        Assume.assumeNotNull(completableFuture);
+        Promise<Integer> promise = new Promise<Integer>();
+        promise.getFuture().completeInto(completableFuture);
+        promise.setValue(42);
+        assertEquals(42, completableGet(completableFuture));
+    }
+
+    @Test
+    public void testCompleteIntoError() throws Throwable {
+        Object completableFuture = newCompletableFuture();
+        Assume.assumeNotNull(completableFuture);
+        Promise<Integer> promise = new Promise<Integer>();
+        promise.getFuture().completeInto(completableFuture);
+        promise.setError("boom");
+        try {
+            completableGet(completableFuture);
+            fail("get() must throw the error");
+        }
+        catch (ExecutionException e) {
+            assertTrue(e.getCause() instanceof QiException);
+            assertEquals("boom", e.getCause().getMessage());
+        }
+    }
+
+    @Test
+    public void testCompleteIntoTimeout() throws Throwable {
+        Object completableFuture = newCompletableFuture();
+        Assume.assumeNotNull(completableFuture);
+        Promise<Integer> promise = new Promise<Integer>();
+        promise.getFuture().withTimeout(50, TimeUnit.MILLISECONDS).completeInto(completableFuture);
+        try {
+            completableGet(completableFuture);
+            fail("get() must throw once the deadline expired");
+        }
+        catch (ExecutionException e) {
+            assertTrue(e.getCause() instanceof TimeoutException);
+        }
+    }
+
+    @Test
+    public void testCompleteIntoCancel() throws Throwable {
+        Object completableFuture = newCompletableFuture();
+        Assume.assumeNotNull(completableFuture);
+        Promise<Integer> promise = new Promise<Integer>();
+        promise.getFuture().completeInto(completableFuture);
+        promise.setCancelled();
+        try {
+            completableGet(completableFuture);
+            fail("get() must throw on a cancelled future");
+        }
+        catch (CancellationException e) {
+            assertTrue((Boolean) invoke(completableFuture, "isCancelled", new Class<?>[0]));
+        }
+    }
+
+    @Test
+    public void testCompleteIntoUnsupported() {
+        Object completableFuture = newCompletableFuture();
+        try {
+            // anything but a CompletableFuture, whether or not the JVM has one
+            Future.of(42).completeInto(new Object());
+            fail("completeInto() must reject a non CompletableFuture");
+        }
+        catch (IllegalArgumentException e) {
+            assertNotNull("CompletableFuture is available", completableFuture);
+        }
+        catch (UnsupportedOperationException e) {
+            assertNull("CompletableFuture is not available", completableFuture);
+        }
+    }
+
+    @Test(expected = IllegalStateException.class)
+    public void testClose() {
+        Future<Integer> future = Future.of(42);
+        assertEquals(42, (int) future.getValue());
+        future.close();
+        // closing twice must have no effect
+        future.close();
+        future.isDone();
+    }
+
+    @Test
+    public void testCloseWhileWaiting() throws InterruptedException {
+        final Promise<Integer> promise = new Promise<Integer>();
+        final Future<Integer> future = promise.getFuture();
+        final AtomicLong result = new AtomicLong(-1);
+        Thread waiter = new Thread(new Runnable() {
+            @Override
+            public void run() {
+                try {
+                    result.set(future.get());
+                }
+                catch (ExecutionException e) {
+                    e.printStackTrace();
+                }
+            }
+        });
+        waiter.start();
+        // let the waiter block in the native get
+        Thread.sleep(100);
+        future.close();
+        // the native future must still be alive for the waiter
+        promise.setValue(42);
+        waiter.join(1000);
+        assertEquals(42, result.get());
+    }
+
+    @Test
+    public void testCancelRequestKeepsResult() throws ExecutionException {
+        Future<String> future = proxy.call(String.class, "longReply", "plaf");
+        future.requestCancellation();
+        // the remote method ignores the request: only abandoned calls drop
+        // their result, not the ones whose caller still waits for it
+        assertEquals("plafbim !", future.get());
+    }
+
+    @Test
+    public void testCancelOnCollect() throws Throwable {
+        final Promise<Integer> promise = new Promise<Integer>();
+        promise.setOnCancel(new Promise.CancelRequestCallback<Integer>() {
+            @Override
+            public void onCancelRequested(Promise<Integer> promise) {
+                promise.setCancelled();
+            }
+        });
+        Future<Integer> future = promise.getFuture().andThenApply(new Function<Integer, Integer>() {
+            @Override
+            public Integer execute(Integer value) throws Throwable {
+                return value;
+            }
+        });
+        // simulate the garbage collection of the abandoned future
+        future.cancelOnCollect().finalize();
+        promise.getFuture().sync(1, TimeUnit.SECONDS);
+        assertTrue(promise.getFuture().isCancelled());
+    }
+
+    @Test
+    public void testGetIsCached() {
+        Future<List<Integer>> future = Future.of(java.util.Arrays.asList(1, 2, 3));
+        assertTrue(future.getValue() == future.getValue());
+    }
+
+    @Test
+    public void testReleaseNativeOnGet() {
+        Future<Integer> future = Future.of(42).releaseNativeOnGet();
+        assertEquals(42, (int) future.getValue());
+        assertTrue(future.isDone());
+        assertTrue(future.isSuccess());
+        assertEquals(42, (int) future.getValue());
+    }
+
+    @Test
+    public void testReleaseNativeOnGetShared() throws InterruptedException {
+        final Promise<List<Integer>> promise = new Promise<List<Integer>>();
+        final Future<List<Integer>> future = promise.getFuture().releaseNativeOnGet();
+        final List<Object> results = new java.util.concurrent.CopyOnWriteArrayList<Object>();
+        Runnable consumer = new Runnable() {
+            @Override
+            public void run() {
+                results.add(future.getValue());
+            }
+        };
+        Thread first = new Thread(consumer);
+        Thread second = new Thread(consumer);
+        first.start();
+        second.start();
+        // let both consumers block in the native get
+        Thread.sleep(100);
+        promise.setValue(java.util.Arrays.asList(1, 2, 3));
+        first.join(1000);
+        second.join(1000);
+
+        // the first get to return releases the native future, not under the
+        // other one, and both get the same value
+        assertEquals(2, results.size());
+        assertTrue(results.get(0) == results.get(1));
+        // late consumers get the kept value
+        assertTrue(future.getValue() == results.get(0));
+    }
+
+    @Test
+    public void testSyncContinuationsKeepThread() throws ExecutionException {
+        final Promise<Integer> promise = new Promise<Integer>();
+        final Function<Integer, Long> threadId = new Function<Integer, Long>() {
+            @Override
+            public Long execute(Integer value) throws Throwable {
+                return Thread.currentThread().getId();
+            }
+        };
+        Future<Long> first = promise.getFuture().andThenApply(threadId, FutureCallbackType.Sync);
+        Future<Long> second = first.andThenApply(new Function<Long, Long>() {
+            @Override
+            public Long execute(Long previous) throws Throwable {
+                return previous == Thread.currentThread().getId() ? previous : -1;
+            }
+        }, FutureCallbackType.Sync);
+        promise.setValue(42);
+        assertEquals(Thread.currentThread().getId(), (long) second.get());
+    }
+
+    @Test
+    public void testContinuationOnExecutor() throws ExecutionException {
+        final Thread[] executorThread = new Thread[1];
+        java.util.concurrent.Executor executor = new java.util.concurrent.Executor() {
+            @Override
+            public void execute(Runnable command) {
+                executorThread[0] = new Thread(command);
+                executorThread[0].start();
+            }
+        };
+        Future<Boolean> future = Future.of(42).andThenApply(new Function<Integer, Boolean>() {
+            @Override
+            public Boolean execute(Integer value) throws Throwable {
+                return Thread.currentThread() == executorThread[0];
+            }
+        }, executor);
+        assertTrue(future.get());
+    }
+
+    @Test
+    public void testChain() throws ExecutionException {
+        final AtomicLong consumed = new AtomicLong();
+        Future<String> future = Future.of(20).chain().andThenApply(new Function<Integer, Integer>() {
+            @Override
+            public Integer execute(Integer value) throws Throwable {
+                return value + 1;
+            }
+        }).andThenConsume(new Consumer<Integer>() {
+            @Override
+            public void consume(Integer value) throws Throwable {
+                consumed.set(value);
+            }
+        }).andThenApply(new Function<Void, String>() {
+            @Override
+            public String execute(Void ignored) throws Throwable {
+                return String.valueOf(consumed.get() * 2);
+            }
+        }).submit();
+        assertEquals("42", future.get());
+    }
+
+    @Test
+    public void testChainError() {
+        Future<Integer> future = Future.of(42).chain().andThenApply(new Function<Integer, Integer>() {
+            @Override
+            public Integer execute(Integer value) throws Throwable {
+                throw new RuntimeException("chain failure");
+            }
+        }).andThenApply(new Function<Integer, Integer>() {
+            @Override
+            public Integer execute(Integer value) throws Throwable {
+                fail("must not be called after a failure");
+                return value;
+            }
+        }).submit(FutureCallbackType.Sync);
+        assertEquals("chain failure", future.getErrorMessage());
+    }
+
+    @Test
+    public void testPolledState() {
+        Promise<Integer> promise = new Promise<Integer>();
+        Future<Integer> future = promise.getFuture();
+        assertFalse(future.isDone());
+        assertFalse(future.isCancelled());
+        promise.setCancelled();
+        // the state word is updated by the native layer
+        assertTrue(future.isDone());
+        assertTrue(future.isCancelled());
+        future.close();
+    }
+
     @Test
     public void testFutureWaitFor() throws ExecutionException, TimeoutException {
         Promise<Long> p = new Promise<Long>();
@@ -769,12 +1148,21 @@ public class FutureTest {
         p.getFuture().get(0, TimeUnit.SECONDS); // must not throw
     }
 
-    // @Test
+    @Test
     public void testAdvertisedFutureReturn() throws ExecutionException, InterruptedException {
-        Future f = proxy.call(Future.class, "getFuture", "toto");
+        Future<String> f = proxy.call(String.class, "getFuture", "toto");
         assertEquals("ENDtoto", f.get());
     }
 
+    @Test
+    public void testAdvertisedFutureThrowing() {
+        Future<String> f = proxy.call(String.class, "getFutureThrowing");
+        f.sync();
+        assertTrue(f.hasError());
+        // thrown without message, the class name is reported instead
+        assertTrue(f.getErrorMessage(), f.getErrorMessage().contains("IllegalStateException"));
+    }
+
     // @Test
     public void testFutureCancelAdvertisedMethod() throws ExecutionException {
         Future f = proxy.call(Future.class, "getCancellableFuture", "toto");
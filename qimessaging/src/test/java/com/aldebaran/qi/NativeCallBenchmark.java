@@ -0,0 +1,67 @@
+package com.aldebaran.qi;
+
+/**
+ * Measure the cost of the trivial native calls.
+ * <p>
+ * Not a unit test, run it with {@code java com.aldebaran.qi.NativeCallBenchmark}.
+ * Running it again with {@code -XX:-CriticalJNINatives} gives the cost of the
+ * plain JNI entry points, for comparison with the critical ones.
+ */
+public class NativeCallBenchmark {
+    private static final int WARMUP_CALLS = 1000000;
+    private static final int CALLS = 10000000;
+
+    private interface Call {
+        boolean run();
+    }
+
+    private static void measure(String name, Call call) {
+        int count = 0;
+
+        for (int i = 0; i < WARMUP_CALLS; i++) {
+            if (call.run()) {
+                count++;
+            }
+        }
+
+        final long start = System.nanoTime();
+
+        for (int i = 0; i < CALLS; i++) {
+            if (call.run()) {
+                count++;
+            }
+        }
+
+        final long elapsed = System.nanoTime() - start;
+        // print count so that the calls are not optimized away
+        System.out.println(String.format("%-24s %6.1f ns/call (%d)", name, (double) elapsed / CALLS, count));
+    }
+
+    public static void main(String[] args) {
+        final Session session = new Session();
+        final Promise<Integer> promise = new Promise<Integer>();
+        final Future<Integer> running = promise.getFuture();
+        final Future<Integer> finished = Future.of(42);
+
+        measure("Session.isConnected()", new Call() {
+            @Override
+            public boolean run() {
+                return session.isConnected();
+            }
+        });
+        measure("Future.isDone() running", new Call() {
+            @Override
+            public boolean run() {
+                return running.isDone();
+            }
+        });
+        measure("Future.isDone() finished", new Call() {
+            @Override
+            public boolean run() {
+                return finished.isDone();
+            }
+        });
+
+        promise.setValue(0);
+    }
+}
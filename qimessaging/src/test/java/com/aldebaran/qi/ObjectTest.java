@@ -7,7 +7,9 @@ package com.aldebaran.qi;
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertNotNull;
+import static org.junit.Assert.assertNotSame;
 import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertSame;
 import static org.junit.Assert.assertTrue;
 import static org.junit.Assert.fail;
 
@@ -16,8 +18,10 @@ import java.util.HashMap;
 import java.util.List;
 import java.util.Map;
 import java.util.concurrent.ExecutionException;
+import java.util.concurrent.TimeUnit;
 
 import org.junit.After;
+import org.junit.Assume;
 import org.junit.Before;
 import org.junit.Test;
 
@@ -133,6 +137,106 @@ public class ObjectTest {
         assertFalse(v0.hasError());
     }
 
+    @Test
+    public void serviceCache() throws Exception {
+        int serviceId = s.registerService("cachedService", new DynamicObjectBuilder().object());
+        AnyObject service = client.service("cachedService").get();
+        assertSame(service, client.service("cachedService").get());
+
+        s.unregisterService(serviceId);
+        Thread.sleep(100); // Give time for the unregistration to be received.
+        assertTrue(client.service("cachedService").hasError());
+    }
+
+    @Test
+    public void serviceCacheCancel() throws Exception {
+        s.registerService("cancelledLookup", new DynamicObjectBuilder().object());
+        Future<AnyObject> cancelled = client.service("cancelledLookup");
+        Future<AnyObject> other = client.service("cancelledLookup");
+        assertNotSame(cancelled, other);
+        // only meaningful while the shared lookup is in flight
+        Assume.assumeTrue(!cancelled.isDone());
+
+        // gives up this call only, not the shared lookup
+        cancelled.requestCancellation();
+        AnyObject service = other.get();
+        assertNotNull(service);
+        assertTrue(cancelled.isCancelled());
+        assertSame(service, client.service("cancelledLookup").get());
+    }
+
+    @Test
+    public void prefetchServices() throws Exception {
+        Session session = new Session();
+        session.connect(sd.listenUrl(), "serviceTest", "serviceTestTs").get();
+        Future<AnyObject> service = session.service("serviceTest");
+        assertTrue(service.isDone());
+        assertNotNull(service.get());
+        session.close();
+    }
+
+    @Test
+    public void prefetchServicesConcurrently() throws Exception {
+        Session session = new Session();
+        session.connect(sd.listenUrl()).get();
+        Future<Void> prefetch = session.prefetchServices("serviceTest", "serviceTestTs");
+        // the lookups are launched, not waited for
+        assertFalse(prefetch.isDone());
+
+        prefetch.get();
+        assertTrue(session.service("serviceTest").isDone());
+        assertTrue(session.service("serviceTestTs").isDone());
+        session.close();
+    }
+
+    @Test
+    public void batchedProperties() throws Exception {
+        AnyObject anyObject = proxy.<AnyObject>call("createObject").get();
+        Map<String, Object> values = new HashMap<String, Object>();
+        values.put("name", "bar");
+        values.put("uid", 12);
+        anyObject.setProperties(values).get();
+
+        Map<String, Object> read = anyObject.getProperties("uid", "name").get();
+        assertEquals(12, read.get("uid"));
+        assertEquals("bar", read.get("name"));
+    }
+
+    @Test
+    public void propertyMirror() throws Exception {
+        AnyObject anyObject = proxy.<AnyObject>call("createObject").get();
+        PropertyMirror<Integer> uid = anyObject.mirrorProperty("uid");
+        assertEquals(42, (int) uid.get());
+
+        anyObject.setProperty("uid", 43).get();
+        Thread.sleep(100); // Give time for the change to be received.
+        assertEquals(43, (int) uid.get());
+        uid.close();
+    }
+
+    @Test
+    public void propertyLastValueCache() throws Exception {
+        AnyObject anyObject = proxy.<AnyObject>call("createObject").get();
+        anyObject.enableLastValueCache("uid", 1, TimeUnit.MINUTES);
+        Thread.sleep(100); // Give time for the subscription to be done.
+        assertEquals(42, (int) anyObject.<Integer>property("uid").get());
+
+        // served by the cache, without any call
+        Future<Integer> cached = anyObject.property("uid");
+        assertTrue(cached.isDone());
+        assertEquals(42, (int) cached.get());
+
+        // the write invalidates the cache, even before the change is received
+        anyObject.setProperty("uid", 43).get();
+        assertEquals(43, (int) anyObject.<Integer>property("uid").get());
+
+        Thread.sleep(100); // Give time for the change to be received.
+        cached = anyObject.property("uid");
+        assertTrue(cached.isDone());
+        assertEquals(43, (int) cached.get());
+        anyObject.disableLastValueCache("uid").sync();
+    }
+
     @Test
     public void getObject() {
         boolean ok;
@@ -1,5 +1,6 @@
 package com.aldebaran.qi;
 
+import java.nio.ByteBuffer;
 import java.util.concurrent.ExecutionException;
 import java.util.concurrent.TimeUnit;
 import java.util.concurrent.TimeoutException;
@@ -17,6 +18,53 @@ public class PromiseTest {
         Assert.assertEquals(42, value);
     }
 
+    @Test
+    public void testTypedSetters() {
+        Promise<Integer> intPromise = new Promise<Integer>();
+        intPromise.setInt(42);
+        Assert.assertEquals(42, (int) intPromise.getFuture().getValue());
+
+        Promise<Long> longPromise = new Promise<Long>();
+        longPromise.setLong(1L << 40);
+        Assert.assertEquals(1L << 40, (long) longPromise.getFuture().getValue());
+
+        Promise<Double> doublePromise = new Promise<Double>();
+        doublePromise.setDouble(0.5);
+        Assert.assertEquals(0.5, doublePromise.getFuture().getValue(), 0);
+
+        Promise<String> stringPromise = new Promise<String>();
+        stringPromise.setString("forty-two");
+        Assert.assertEquals("forty-two", stringPromise.getFuture().getValue());
+
+        Promise<Void> voidPromise = new Promise<Void>();
+        voidPromise.setVoid();
+        Assert.assertNull(voidPromise.getFuture().getValue());
+    }
+
+    @Test
+    public void testSetBytes() {
+        byte[] bytes = new byte[] { 4, 2, 0 };
+        Promise<ByteBuffer> promise = new Promise<ByteBuffer>();
+        promise.setBytes(bytes);
+        ByteBuffer buffer = promise.getFuture().getValue();
+        Assert.assertEquals(bytes.length, buffer.capacity());
+        Assert.assertArrayEquals(bytes, buffer.array());
+    }
+
+    @Test(expected = NullPointerException.class)
+    public void testSetBytesNull() {
+        new Promise<ByteBuffer>().setBytes(null);
+    }
+
+    @Test
+    public void testSetValues() {
+        Promise<Integer> first = new Promise<Integer>();
+        Promise<String> second = new Promise<String>();
+        Promise.setValues(new Promise<?>[] { first, second }, new Object[] { 42, "42" });
+        Assert.assertEquals(42, (int) first.getFuture().getValue());
+        Assert.assertEquals("42", second.getFuture().getValue());
+    }
+
     @Test
     public void testPromiseError() {
         Promise<Integer> promise = new Promise<Integer>();
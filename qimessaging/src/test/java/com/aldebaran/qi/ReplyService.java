@@ -212,6 +212,11 @@ public class ReplyService extends QiService {
         return promise.getFuture();
     }
 
+    public Future<String> getFutureThrowing() {
+        // no message on purpose
+        throw new IllegalStateException();
+    }
+
     public Future<String> getCancellableFuture(final String param) {
         final Promise<String> promise = new Promise<String>();
         promise.setOnCancel(new Promise.CancelRequestCallback<String>() {